@@ -0,0 +1,299 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "allocator.h"
+
+#include "debug.h"
+#include "scopedMutex.h"
+#include "spinLock.h"
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace lunchbox
+{
+namespace
+{
+typedef AlignedAllocator< HugePageAllocator::HUGE_PAGE_SIZE > HugeAllocator;
+
+bool _isHuge( const size_t size )
+{
+    return size >= size_t( HugePageAllocator::HUGE_PAGE_SIZE );
+}
+
+size_t _queryPageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return info.dwPageSize;
+#else
+    return ::sysconf( _SC_PAGESIZE );
+#endif
+}
+
+size_t _getPageSize()
+{
+    static const size_t pageSize = _queryPageSize();
+    return pageSize;
+}
+
+size_t _getMappedSize( const size_t size )
+{
+    const size_t pageSize = _getPageSize();
+    return ( size + pageSize - 1 ) & ~( pageSize - 1 );
+}
+
+// Pool block sizes are powers of two from MIN_SIZE to MAX_SIZE
+size_t _getPoolIndex( const size_t size )
+{
+    size_t index = 0;
+    for( size_t blockSize = PoolAllocator::MIN_SIZE; blockSize < size;
+         blockSize <<= 1 )
+    {
+        ++index;
+    }
+    return index;
+}
+
+bool _isPooled( const size_t size )
+{
+    return size <= size_t( PoolAllocator::MAX_SIZE );
+}
+
+struct BlockCache
+{
+    SpinLock lock;
+    std::vector< void* > blocks;
+};
+
+class BlockPool
+{
+public:
+    enum { NSIZES = 15 }; // log2( MAX_SIZE / MIN_SIZE ) + 1
+
+    BlockCache& operator[]( const size_t index )
+    {
+        LBASSERT( index < NSIZES );
+        return _caches[ index ];
+    }
+
+    void flush()
+    {
+        for( size_t i = 0; i < NSIZES; ++i )
+        {
+            BlockCache& cache = _caches[ i ];
+            ScopedFastWrite mutex( cache.lock );
+            for( size_t j = 0; j < cache.blocks.size(); ++j )
+                ::free( cache.blocks[ j ] );
+            cache.blocks.clear();
+        }
+    }
+
+private:
+    BlockCache _caches[ NSIZES ];
+};
+
+// Leaked to stay usable by buffers of static objects, see flush()
+BlockPool& _getBlockPool()
+{
+    static BlockPool* pool = new BlockPool;
+    return *pool;
+}
+}
+
+void* HugePageAllocator::allocate( const size_t size )
+{
+    if( !_isHuge( size ))
+        return MallocAllocator::allocate( size );
+
+    void* ptr = HugeAllocator::allocate( size );
+#ifdef MADV_HUGEPAGE
+    if( ptr && ::madvise( ptr, size, MADV_HUGEPAGE ) != 0 )
+        LBVERB << "Huge page advice failed: " << sysError << std::endl;
+#endif
+    return ptr;
+}
+
+void* HugePageAllocator::reallocate( void* ptr, const size_t oldSize,
+                                     const size_t newSize )
+{
+    if( !ptr )
+        return allocate( newSize );
+    if( !_isHuge( oldSize ) && !_isHuge( newSize ))
+        return MallocAllocator::reallocate( ptr, oldSize, newSize );
+    if( newSize == 0 )
+    {
+        deallocate( ptr, oldSize );
+        return 0;
+    }
+
+    void* newPtr = allocate( newSize );
+    if( !newPtr )
+        return 0; // keep ptr, like realloc
+    ::memcpy( newPtr, ptr, std::min( oldSize, newSize ));
+    deallocate( ptr, oldSize );
+    return newPtr;
+}
+
+void HugePageAllocator::deallocate( void* ptr, const size_t size )
+{
+    if( _isHuge( size ))
+        HugeAllocator::deallocate( ptr, size );
+    else
+        MallocAllocator::deallocate( ptr, size );
+}
+
+void* MMapAllocator::allocate( const size_t size )
+{
+    if( size == 0 )
+        return 0;
+#ifdef _WIN32
+    void* ptr = ::VirtualAlloc( 0, size, MEM_COMMIT | MEM_RESERVE,
+                                PAGE_READWRITE );
+    if( !ptr )
+#else
+    void* ptr = ::mmap( 0, _getMappedSize( size ), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANON, -1, 0 );
+    if( ptr == MAP_FAILED )
+#endif
+    {
+        LBWARN << "Memory mapping of " << size << " bytes failed: " << sysError
+               << std::endl;
+        return 0;
+    }
+    return ptr;
+}
+
+void* MMapAllocator::reallocate( void* ptr, const size_t oldSize,
+                                 const size_t newSize )
+{
+    if( !ptr )
+        return allocate( newSize );
+    if( newSize == 0 )
+    {
+        deallocate( ptr, oldSize );
+        return 0;
+    }
+
+    const size_t oldMapped = _getMappedSize( oldSize );
+    const size_t newMapped = _getMappedSize( newSize );
+    if( oldMapped == newMapped )
+        return ptr;
+
+#ifdef MREMAP_MAYMOVE
+    void* newPtr = ::mremap( ptr, oldMapped, newMapped, MREMAP_MAYMOVE );
+    if( newPtr != MAP_FAILED )
+        return newPtr;
+    LBWARN << "Memory remapping of " << newSize << " bytes failed: "
+           << sysError << std::endl;
+    return 0;
+#else
+    void* newPtr = allocate( newSize );
+    if( !newPtr )
+        return 0; // keep ptr, like realloc
+    ::memcpy( newPtr, ptr, std::min( oldSize, newSize ));
+    deallocate( ptr, oldSize );
+    return newPtr;
+#endif
+}
+
+void MMapAllocator::deallocate( void* ptr, const size_t size )
+{
+    if( !ptr )
+        return;
+#ifdef _WIN32
+    ::VirtualFree( ptr, 0, MEM_RELEASE );
+#else
+    ::munmap( ptr, _getMappedSize( size ));
+#endif
+}
+
+void* PoolAllocator::allocate( const size_t size )
+{
+    if( size == 0 )
+        return 0;
+    if( !_isPooled( size ))
+        return ::malloc( size );
+
+    const size_t index = _getPoolIndex( size );
+    BlockCache& cache = _getBlockPool()[ index ];
+    {
+        ScopedFastWrite mutex( cache.lock );
+        if( !cache.blocks.empty( ))
+        {
+            void* ptr = cache.blocks.back();
+            cache.blocks.pop_back();
+            return ptr;
+        }
+    }
+    return ::malloc( size_t( MIN_SIZE ) << index );
+}
+
+void* PoolAllocator::reallocate( void* ptr, const size_t oldSize,
+                                 const size_t newSize )
+{
+    if( !ptr )
+        return allocate( newSize );
+    if( newSize == 0 )
+    {
+        deallocate( ptr, oldSize );
+        return 0;
+    }
+
+    const bool oldPooled = _isPooled( oldSize );
+    const bool newPooled = _isPooled( newSize );
+    if( !oldPooled && !newPooled )
+        return ::realloc( ptr, newSize );
+    if( oldPooled && newPooled &&
+        _getPoolIndex( oldSize ) == _getPoolIndex( newSize ))
+    {
+        return ptr;
+    }
+
+    void* newPtr = allocate( newSize );
+    if( !newPtr )
+        return 0; // keep ptr, like realloc
+    ::memcpy( newPtr, ptr, std::min( oldSize, newSize ));
+    deallocate( ptr, oldSize );
+    return newPtr;
+}
+
+void PoolAllocator::deallocate( void* ptr, const size_t size )
+{
+    if( !ptr )
+        return;
+    if( _isPooled( size ))
+    {
+        BlockCache& cache = _getBlockPool()[ _getPoolIndex( size )];
+        ScopedFastWrite mutex( cache.lock );
+        if( cache.blocks.size() < MAX_CACHED )
+        {
+            cache.blocks.push_back( ptr );
+            return;
+        }
+    }
+    ::free( ptr );
+}
+
+void PoolAllocator::flush()
+{
+    _getBlockPool().flush();
+}
+}
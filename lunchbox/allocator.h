@@ -0,0 +1,191 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_ALLOCATOR_H
+#define LUNCHBOX_ALLOCATOR_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/os.h>    // malloc, _aligned_malloc
+#include <lunchbox/types.h>
+
+#include <algorithm> // std::min
+#include <cstring>   // memcpy
+
+/**
+ * @file lunchbox/allocator.h
+ *
+ * Memory allocation policies for Buffer.
+ *
+ * An allocation policy provides three static methods working on raw bytes:
+ * - <code>void* allocate( size_t size )</code> allocates at least the given
+ *   number of bytes and returns 0 for a zero size.
+ * - <code>void* reallocate( void* ptr, size_t oldSize, size_t newSize )</code>
+ *   resizes an allocation, preserving the first min( oldSize, newSize ) bytes.
+ *   It allocates if ptr is 0 and deallocates if newSize is 0. Like realloc,
+ *   it returns 0 and keeps ptr valid if the allocation fails.
+ * - <code>void deallocate( void* ptr, size_t size )</code> releases an
+ *   allocation. A 0 pointer is ignored.
+ *
+ * The sizes passed to reallocate() and deallocate() are the sizes requested
+ * for the given pointer.
+ */
+
+namespace lunchbox
+{
+/** Allocates using malloc, realloc and free. @version 1.11 */
+struct MallocAllocator
+{
+    static void* allocate( const size_t size )
+        { return size ? ::malloc( size ) : 0; }
+
+    static void* reallocate( void* ptr, const size_t, const size_t newSize )
+    {
+        if( newSize == 0 )
+        {
+            ::free( ptr );
+            return 0;
+        }
+        return ::realloc( ptr, newSize );
+    }
+
+    static void deallocate( void* ptr, const size_t ) { ::free( ptr ); }
+};
+
+/**
+ * Allocates memory aligned to the given power-of-two number of bytes.
+ *
+ * The default alignment of 64 bytes fits a cache line and the widest SIMD
+ * registers. Reallocation always copies the data.
+ * @version 1.11
+ */
+template< size_t alignment = 64 > struct AlignedAllocator
+{
+    static void* allocate( const size_t size )
+    {
+        if( size == 0 )
+            return 0;
+#ifdef _WIN32
+        return ::_aligned_malloc( size, alignment );
+#else
+        void* ptr = 0;
+        if( ::posix_memalign( &ptr, alignment, size ) != 0 )
+            return 0;
+        return ptr;
+#endif
+    }
+
+    static void* reallocate( void* ptr, const size_t oldSize,
+                             const size_t newSize )
+    {
+        if( oldSize == newSize && ptr )
+            return ptr;
+        if( newSize == 0 )
+        {
+            deallocate( ptr, oldSize );
+            return 0;
+        }
+
+        void* newPtr = allocate( newSize );
+        if( !newPtr )
+            return 0; // keep ptr, like realloc
+        if( ptr )
+            ::memcpy( newPtr, ptr, std::min( oldSize, newSize ));
+        deallocate( ptr, oldSize );
+        return newPtr;
+    }
+
+    static void deallocate( void* ptr, const size_t )
+    {
+#ifdef _WIN32
+        ::_aligned_free( ptr );
+#else
+        ::free( ptr );
+#endif
+    }
+};
+
+/**
+ * Allocates large blocks eligible for transparent huge pages.
+ *
+ * Allocations of at least HUGE_PAGE_SIZE bytes are aligned to the huge page
+ * size and, on Linux, advised to be backed by transparent huge pages, which
+ * reduces TLB misses on large buffers. Smaller allocations use malloc.
+ * @version 1.11
+ */
+struct HugePageAllocator
+{
+    enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 }; //!< Huge page size in bytes
+
+    static LUNCHBOX_API void* allocate( size_t size );
+    static LUNCHBOX_API void* reallocate( void* ptr, size_t oldSize,
+                                          size_t newSize );
+    static LUNCHBOX_API void deallocate( void* ptr, size_t size );
+};
+
+/**
+ * Allocates whole pages directly from the operating system.
+ *
+ * On Linux, reallocation uses mremap(), which grows and shrinks allocations by
+ * remapping pages instead of copying the data. This makes growing very large
+ * buffers independent of their size. Other platforms copy on reallocation.
+ * @version 1.11
+ */
+struct MMapAllocator
+{
+    static LUNCHBOX_API void* allocate( size_t size );
+    static LUNCHBOX_API void* reallocate( void* ptr, size_t oldSize,
+                                          size_t newSize );
+    static LUNCHBOX_API void deallocate( void* ptr, size_t size );
+};
+
+/**
+ * Allocates from a process-wide, thread-safe pool of power-of-two blocks.
+ *
+ * Sizes are rounded up to the next power of two of at least MIN_SIZE bytes.
+ * Deallocated blocks are cached per size and reused by later allocations,
+ * avoiding the global heap for frequently recycled small buffers. Each size
+ * keeps at most MAX_CACHED blocks. Reallocation within the rounded block size
+ * returns the same block. Sizes above MAX_SIZE bypass the pool.
+ * @version 1.11
+ */
+struct PoolAllocator
+{
+    enum
+    {
+        MIN_SIZE = 64,          //!< The smallest pooled block size
+        MAX_SIZE = 1024 * 1024, //!< The largest pooled block size
+        MAX_CACHED = 32         //!< The maximum cached blocks per size
+    };
+
+    static LUNCHBOX_API void* allocate( size_t size );
+    static LUNCHBOX_API void* reallocate( void* ptr, size_t oldSize,
+                                          size_t newSize );
+    static LUNCHBOX_API void deallocate( void* ptr, size_t size );
+
+    /**
+     * Release all cached blocks.
+     *
+     * The pool is never destroyed, so that buffers of static objects may
+     * be released at any time. Call this method at shutdown to return the
+     * cached memory.
+     * @version 1.11
+     */
+    static LUNCHBOX_API void flush();
+};
+}
+
+#endif // LUNCHBOX_ALLOCATOR_H
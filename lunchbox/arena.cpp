@@ -0,0 +1,162 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "arena.h"
+
+#include "debug.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace lunchbox
+{
+namespace
+{
+// @return the offset of the first aligned address at or after offset
+size_t _align( const uint8_t* data, const size_t offset,
+               const size_t alignment )
+{
+    LBASSERTINFO( ( alignment & ( alignment - 1 )) == 0, alignment );
+    const uintptr_t address = uintptr_t( data + offset );
+    const uintptr_t aligned = ( address + alignment - 1 ) & ~( alignment - 1 );
+    return offset + ( aligned - address );
+}
+}
+
+Arena::Arena( const size_t blockSize )
+    : _blockSize( blockSize )
+    , _block( 0 )
+    , _offset( 0 )
+    , _last( 0 )
+    , _free( 0 )
+{}
+
+Arena::~Arena()
+{
+    clear();
+}
+
+void* Arena::allocate( const size_t size, const size_t alignment )
+{
+    if( size == 0 )
+        return 0;
+
+    if( !_blocks.empty( ))
+    {
+        const Block& block = _blocks[ _block ];
+        const size_t start = _align( block.data, _offset, alignment );
+        if( start + size <= block.size )
+        {
+            _free = _offset;
+            _last = start;
+            _offset = start + size;
+            return block.data + start;
+        }
+    }
+
+    // continue in the next block, insert a new one if it is too small
+    const size_t needed = size + alignment - 1;
+    const size_t next = _blocks.empty() ? 0 : _block + 1;
+    if( next >= _blocks.size() || _blocks[ next ].size < needed )
+    {
+        Block block;
+        block.size = std::max( _blockSize, needed );
+        block.data = static_cast< uint8_t* >( ::malloc( block.size ));
+        if( !block.data )
+            throw std::bad_alloc();
+        _blocks.insert( _blocks.begin() + next, block );
+    }
+
+    const Block& block = _blocks[ next ];
+    _block = next;
+    _free = 0;
+    _last = _align( block.data, 0, alignment );
+    _offset = _last + size;
+    return block.data + _last;
+}
+
+void* Arena::reallocate( void* ptr, const size_t oldSize,
+                         const size_t newSize )
+{
+    if( !ptr )
+        return allocate( newSize );
+    if( newSize == 0 )
+    {
+        deallocate( ptr, oldSize );
+        return 0;
+    }
+
+    if( _last != _offset && ptr == _blocks[ _block ].data + _last &&
+        _last + newSize <= _blocks[ _block ].size )
+    {
+        _offset = _last + newSize;
+        return ptr;
+    }
+
+    void* newPtr = allocate( newSize );
+    ::memcpy( newPtr, ptr, std::min( oldSize, newSize ));
+    return newPtr;
+}
+
+void Arena::deallocate( void* ptr, const size_t )
+{
+    if( ptr && _last != _offset && ptr == _blocks[ _block ].data + _last )
+        _offset = _last = _free;
+}
+
+void Arena::rewind( const Marker& marker )
+{
+    LBASSERT( marker.block < _block ||
+              ( marker.block == _block && marker.offset <= _offset ));
+    _block = marker.block;
+    _offset = marker.offset;
+    _last = _free = _offset;
+}
+
+void Arena::reset()
+{
+    _block = 0;
+    _offset = 0;
+    _last = 0;
+    _free = 0;
+}
+
+void Arena::clear()
+{
+    for( size_t i = 0; i < _blocks.size(); ++i )
+        ::free( _blocks[ i ].data );
+    _blocks.clear();
+    reset();
+}
+
+size_t Arena::getUsedSize() const
+{
+    size_t size = _offset;
+    for( size_t i = 0; i < _block; ++i )
+        size += _blocks[ i ].size;
+    return size;
+}
+
+size_t Arena::getAllocatedSize() const
+{
+    size_t size = 0;
+    for( size_t i = 0; i < _blocks.size(); ++i )
+        size += _blocks[ i ].size;
+    return size;
+}
+}
@@ -0,0 +1,230 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_ARENA_H
+#define LUNCHBOX_ARENA_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+#include <cstddef> // ptrdiff_t
+#include <limits>
+#include <new>     // placement new, std::bad_alloc
+#include <vector>
+
+namespace lunchbox
+{
+/**
+ * A bump-pointer allocator for short-lived allocations.
+ *
+ * Memory is allocated by advancing a pointer within large blocks, and is not
+ * released individually. Instead, reset() releases all allocations at once,
+ * and rewind() releases all allocations made after a given Marker. Blocks are
+ * kept for reuse, so a recurring workload, e.g., per-frame temporary data,
+ * stops allocating from the heap after the first iteration. Objects allocated
+ * from an arena are not destructed.
+ *
+ * ArenaAllocator adapts an arena for standard containers, and
+ * ArenaBufferAllocator provides an allocation policy for Buffer.
+ *
+ * An arena is not thread-safe. Per-thread arenas can be set up using
+ * PerThread< Arena >.
+ *
+ * Example: @include tests/arena.cpp
+ */
+class Arena : public boost::noncopyable
+{
+public:
+    /** A position in the arena to rewind to. @version 1.11 */
+    struct Marker
+    {
+        size_t block;
+        size_t offset;
+    };
+
+    /**
+     * Releases all allocations made during its lifetime on destruction.
+     * @version 1.11
+     */
+    class Scope : public boost::noncopyable
+    {
+    public:
+        explicit Scope( Arena& arena )
+            : _arena( arena ), _marker( arena.getMarker( )) {}
+        ~Scope() { _arena.rewind( _marker ); }
+
+    private:
+        Arena& _arena;
+        const Marker _marker;
+    };
+
+    enum { DEFAULT_ALIGNMENT = 16 }; //!< Alignment of allocations in bytes
+
+    /**
+     * Construct a new arena.
+     *
+     * @param blockSize the size of the allocated blocks in bytes. Larger
+     *                  allocations use a block of their size.
+     * @version 1.11
+     */
+    LUNCHBOX_API explicit Arena( size_t blockSize = 65536 );
+
+    /** Destruct the arena and free all blocks. @version 1.11 */
+    LUNCHBOX_API ~Arena();
+
+    /**
+     * Allocate memory from the arena.
+     *
+     * @param size the number of bytes.
+     * @param alignment the power-of-two alignment of the returned memory.
+     * @return the allocated memory, or 0 for a zero size.
+     * @version 1.11
+     */
+    LUNCHBOX_API void* allocate( size_t size,
+                                 size_t alignment = DEFAULT_ALIGNMENT );
+
+    /**
+     * Resize an allocation.
+     *
+     * The most recent allocation is resized in place if it fits its block.
+     * Other allocations are copied to a new allocation.
+     * @version 1.11
+     */
+    LUNCHBOX_API void* reallocate( void* ptr, size_t oldSize, size_t newSize );
+
+    /**
+     * Release an allocation.
+     *
+     * Only the most recent allocation is released immediately, the memory of
+     * other allocations is released on reset() or rewind().
+     * @version 1.11
+     */
+    LUNCHBOX_API void deallocate( void* ptr, size_t size );
+
+    /** @return the current position of the arena. @version 1.11 */
+    Marker getMarker() const
+        { const Marker marker = { _block, _offset }; return marker; }
+
+    /**
+     * Release all allocations made after the given marker was taken.
+     *
+     * Markers taken after the given one become invalid.
+     * @version 1.11
+     */
+    LUNCHBOX_API void rewind( const Marker& marker );
+
+    /** Release all allocations, keeping the blocks for reuse. @version 1.11 */
+    LUNCHBOX_API void reset();
+
+    /** Release all allocations and free all blocks. @version 1.11 */
+    LUNCHBOX_API void clear();
+
+    /** @return the number of bytes in use. @version 1.11 */
+    LUNCHBOX_API size_t getUsedSize() const;
+
+    /** @return the number of bytes of all blocks. @version 1.11 */
+    LUNCHBOX_API size_t getAllocatedSize() const;
+
+private:
+    struct Block
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    const size_t _blockSize;
+    std::vector< Block > _blocks;
+    size_t _block;  // index of the current block
+    size_t _offset; // first free byte in the current block
+    size_t _last;   // offset of the most recent allocation
+    size_t _free;   // first free byte before the most recent allocation
+};
+
+/**
+ * A standard allocator allocating from an Arena.
+ *
+ * Deallocation only releases the most recent allocation, see
+ * Arena::deallocate(). The arena has to outlive all containers using it.
+ * @version 1.11
+ */
+template< class T > class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template< class U > struct rebind { typedef ArenaAllocator< U > other; };
+
+    explicit ArenaAllocator( Arena& arena ) : _arena( &arena ) {}
+    template< class U > ArenaAllocator( const ArenaAllocator< U >& from )
+        : _arena( &from.getArena( )) {}
+
+    pointer allocate( const size_type n, const void* = 0 )
+        { return static_cast< pointer >( _arena->allocate( n * sizeof( T ))); }
+
+    void deallocate( const pointer ptr, const size_type n )
+        { _arena->deallocate( ptr, n * sizeof( T )); }
+
+    void construct( const pointer ptr, const T& value )
+        { new( ptr ) T( value ); }
+    void destroy( const pointer ptr ) { ptr->~T(); }
+
+    pointer address( reference value ) const { return &value; }
+    const_pointer address( const_reference value ) const { return &value; }
+    size_type max_size() const
+        { return std::numeric_limits< size_type >::max() / sizeof( T ); }
+
+    Arena& getArena() const { return *_arena; }
+
+    template< class U >
+    bool operator == ( const ArenaAllocator< U >& rhs ) const
+        { return _arena == &rhs.getArena(); }
+    template< class U >
+    bool operator != ( const ArenaAllocator< U >& rhs ) const
+        { return _arena != &rhs.getArena(); }
+
+private:
+    Arena* _arena;
+};
+
+/**
+ * A Buffer allocation policy allocating from the Arena returned by F.
+ *
+ * F may, for example, return a per-thread arena. Growing a Buffer which holds
+ * the most recent allocation of its arena does not copy its data.
+ * @version 1.11
+ */
+template< Arena& (*F)() > struct ArenaBufferAllocator
+{
+    static void* allocate( const size_t size ) { return F().allocate( size ); }
+
+    static void* reallocate( void* ptr, const size_t oldSize,
+                             const size_t newSize )
+        { return F().reallocate( ptr, oldSize, newSize ); }
+
+    static void deallocate( void* ptr, const size_t size )
+        { F().deallocate( ptr, size ); }
+};
+}
+
+#endif // LUNCHBOX_ARENA_H
@@ -0,0 +1,115 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_ASYNC_H
+#define LUNCHBOX_ASYNC_H
+
+#include <lunchbox/promise.h>    // used inline
+#include <lunchbox/threadPool.h> // used inline
+
+#include <boost/type_traits/is_void.hpp>
+#include <boost/utility/result_of.hpp>
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+namespace detail
+{
+/** Runs a function once, fulfilling a promise with its result. */
+template< class R, class F > class AsyncTask
+{
+public:
+    explicit AsyncTask( const F& func ) : func_( func ) {}
+
+    Future< R > getFuture() const { return promise_.getFuture(); }
+
+    void operator()()
+    {
+        if( promise_.start( )) // not cancelled
+            _run( boost::is_void< R >( ));
+    }
+
+private:
+    F func_;
+    Promise< R > promise_;
+
+    void _run( boost::false_type )
+    {
+        try
+        {
+            promise_.setValue( func_( ));
+        }
+        catch( ... )
+        {
+            promise_.setException( boost::current_exception( ));
+        }
+    }
+
+    void _run( boost::true_type )
+    {
+        try
+        {
+            func_();
+            promise_.setValue();
+        }
+        catch( ... )
+        {
+            promise_.setException( boost::current_exception( ));
+        }
+    }
+};
+}
+/** @endcond */
+
+/**
+ * Run a function asynchronously using the given executor.
+ *
+ * Waiting on the returned future rethrows exceptions thrown by the function.
+ * Cancelling the future before the function has started prevents it from
+ * running.
+ *
+ * @param executor the executor running the function.
+ * @param func the function, taking no parameters.
+ * @return the future result of the function.
+ * @version 1.11
+ */
+template< class F > inline
+Future< typename boost::result_of< F() >::type > async( Executor& executor,
+                                                        F func )
+{
+    typedef typename boost::result_of< F() >::type R;
+    const detail::AsyncTask< R, F > task( func );
+    executor.post( task );
+    return task.getFuture();
+}
+
+/**
+ * Run a function asynchronously using the default thread pool.
+ *
+ * @param func the function, taking no parameters.
+ * @return the future result of the function.
+ * @sa ThreadPool::getDefault()
+ * @version 1.11
+ */
+template< class F > inline
+Future< typename boost::result_of< F() >::type > async( F func )
+{
+    return async( ThreadPool::getDefault(), func );
+}
+}
+
+#endif // LUNCHBOX_ASYNC_H
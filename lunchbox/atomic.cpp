@@ -122,6 +122,15 @@ bool Atomic< ssize_t >::compareAndSwap( ssize_t* value, const ssize_t expected,
            expected;
 }
 
+// On _WIN64, int64_t is ssize_t and implemented above
+template<>
+bool Atomic< int64_t >::compareAndSwap( int64_t* value, const int64_t expected,
+                                        const int64_t newValue )
+{
+    return InterlockedCompareExchange64( value, newValue, expected ) ==
+           expected;
+}
+
 #  endif // else _WIN64
 #endif // _MSC_VER
 
@@ -0,0 +1,190 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "barrier.h"
+
+#include "allocator.h"
+#include "atomic.h"
+#include "debug.h"
+#include "monitor.h"
+
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace lunchbox
+{
+namespace
+{
+static const size_t _fanIn = 4; // children per tree node
+static const ssize_t _root = -1;
+enum { _lineSize = 64 }; // node stride, one cache line each
+
+/** A counter of the threads arriving at a node. */
+struct Node
+{
+    Node( const size_t size_, const ssize_t parent_ )
+        : count( int32_t( size_ )), size( int32_t( size_ )), parent( parent_ )
+    {}
+
+    a_int32_t count;
+    int32_t size;
+    ssize_t parent;
+};
+BOOST_STATIC_ASSERT( sizeof( Node ) <= _lineSize );
+}
+
+namespace detail
+{
+class Barrier
+{
+    typedef AlignedAllocator< _lineSize > Allocator;
+
+public:
+    Barrier( const size_t size_, const lunchbox::Barrier::Mode mode_,
+             const lunchbox::Barrier::Callback& completion_ )
+        : size( size_ )
+        , mode( mode_ )
+        , completion( completion_ )
+        , nodes( 0 )
+        , nNodes( 0 )
+    {
+        LBASSERT( size > 0 );
+        const std::vector< Node > tree = _buildTree();
+
+        nodes = static_cast< char* >(
+            Allocator::allocate( tree.size() * _lineSize ));
+        if( !nodes )
+            throw std::bad_alloc();
+        for( ; nNodes < tree.size(); ++nNodes )
+            new( nodes + nNodes * _lineSize ) Node( tree[ nNodes ] );
+    }
+
+    ~Barrier()
+    {
+        for( size_t i = 0; i < nNodes; ++i )
+            _getNode( i ).~Node();
+        Allocator::deallocate( nodes, nNodes * _lineSize );
+    }
+
+    bool enter( const size_t index )
+    {
+        const uint32_t current = phase.get(); // before arriving
+
+        size_t node = 0;
+        if( mode == lunchbox::Barrier::TREE )
+        {
+            LBASSERTINFO( index < size, index << " >= " << size );
+            node = index / _fanIn;
+        }
+
+        while( true )
+        {
+            Node& arrival = _getNode( node );
+            if( --arrival.count > 0 )
+            {
+                phase.waitNE( current ); // spins before blocking
+                return false;
+            }
+
+            // last thread of this node, reset it and proceed to the parent
+            arrival.count = arrival.size;
+            if( arrival.parent == _root )
+                break;
+            node = arrival.parent;
+        }
+
+        if( completion )
+            completion();
+        ++phase;
+        return true;
+    }
+
+    const size_t size;
+    const lunchbox::Barrier::Mode mode;
+    const lunchbox::Barrier::Callback completion;
+    char* nodes; // nNodes Node's, each on its own cache line
+    size_t nNodes;
+    Monitor< uint32_t > phase;
+
+private:
+    Node& _getNode( const size_t index )
+    {
+        LBASSERT( index < nNodes );
+        return *reinterpret_cast< Node* >( nodes + index * _lineSize );
+    }
+
+    std::vector< Node > _buildTree() const
+    {
+        std::vector< Node > tree;
+        if( mode == lunchbox::Barrier::CENTRAL )
+        {
+            tree.push_back( Node( size, _root ));
+            return tree;
+        }
+
+        // Build the tree level by level, starting with the leaves
+        size_t begin = 0;
+        size_t nChildren = size;
+        while( true )
+        {
+            const size_t nLevel = ( nChildren + _fanIn - 1 ) / _fanIn;
+            const size_t end = begin + nLevel;
+            for( size_t i = 0; i < nLevel; ++i )
+            {
+                const size_t nodeSize = std::min( _fanIn,
+                                                  nChildren - i * _fanIn );
+                const ssize_t parent = nLevel == 1 ? _root :
+                                       ssize_t( end + i / _fanIn );
+                tree.push_back( Node( nodeSize, parent ));
+            }
+            if( nLevel == 1 )
+                return tree;
+            begin = end;
+            nChildren = nLevel;
+        }
+    }
+};
+}
+
+Barrier::Barrier( const size_t size, const Mode mode,
+                  const Callback& completion )
+    : _impl( new detail::Barrier( size, mode, completion ))
+{}
+
+Barrier::~Barrier()
+{
+    delete _impl;
+}
+
+bool Barrier::enter( const size_t index )
+{
+    return _impl->enter( index );
+}
+
+size_t Barrier::getSize() const
+{
+    return _impl->size;
+}
+
+uint32_t Barrier::getPhase() const
+{
+    return _impl->phase.get();
+}
+
+}
@@ -0,0 +1,99 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_BARRIER_H
+#define LUNCHBOX_BARRIER_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/function/function0.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+namespace detail { class Barrier; }
+
+/**
+ * A reusable barrier synchronizing a fixed number of threads.
+ *
+ * Each thread entering the barrier is blocked until all threads of the
+ * current phase have entered it. The barrier flips its phase when the last
+ * thread enters, after which it is immediately usable for the next phase.
+ * Waiting threads spin for a short time using a SpinWait before blocking,
+ * which keeps the latency of short phases low without burning cycles on long
+ * ones.
+ *
+ * In the default CENTRAL mode, all threads count down a single shared
+ * counter. In TREE mode, threads arrive at the leaves of a combining tree
+ * and only the last thread of each node proceeds to its parent, which
+ * reduces the contention on the counters for high thread counts. TREE mode
+ * needs a distinct index per thread, given to enter().
+ *
+ * Example: @include tests/barrier.cpp
+ */
+class Barrier : public boost::noncopyable
+{
+public:
+    /** The arrival strategy of the barrier. @version 1.11 */
+    enum Mode
+    {
+        CENTRAL, //!< A single shared counter
+        TREE     //!< A combining tree of counters
+    };
+
+    /** Function called by the last thread entering a phase. @version 1.11 */
+    typedef boost::function< void() > Callback;
+
+    /**
+     * Construct a new barrier.
+     *
+     * @param size the number of threads synchronized by the barrier.
+     * @param mode the arrival strategy.
+     * @param completion called once per phase by the last entering thread,
+     *                   before the other threads are released.
+     * @version 1.11
+     */
+    LUNCHBOX_API explicit Barrier( size_t size, Mode mode = CENTRAL,
+                                   const Callback& completion = Callback( ));
+
+    /** Destruct the barrier. No thread may wait on it. @version 1.11 */
+    LUNCHBOX_API ~Barrier();
+
+    /**
+     * Enter the barrier and wait until all threads have entered it.
+     *
+     * @param index the index of the calling thread in [0, getSize()), only
+     *              used in TREE mode.
+     * @return true for the single thread completing the phase, false for all
+     *         other threads.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool enter( size_t index = 0 );
+
+    /** @return the number of threads synchronized. @version 1.11 */
+    LUNCHBOX_API size_t getSize() const;
+
+    /** @return the number of completed phases. @version 1.11 */
+    LUNCHBOX_API uint32_t getPhase() const;
+
+private:
+    detail::Barrier* const _impl;
+};
+}
+
+#endif // LUNCHBOX_BARRIER_H
@@ -19,12 +19,15 @@
 #ifndef LUNCHBOX_BUFFER_H
 #define LUNCHBOX_BUFFER_H
 
-#include <lunchbox/debug.h>       // LBASSERT macro
-#include <lunchbox/os.h>          // setZero used inline
+#include <lunchbox/allocator.h>      // default template parameter
+#include <lunchbox/debug.h>          // LBASSERT macro
+#include <lunchbox/os.h>             // setZero used inline
+#include <lunchbox/parallelMemory.h> // used inline
 #include <lunchbox/types.h>
 
 #include <cstdlib>      // for malloc
 #include <cstring>      // for memcpy
+#include <new>          // for std::bad_alloc
 
 namespace lunchbox
 {
@@ -39,8 +42,12 @@ namespace lunchbox
  * elements. Primarily used for binary data, e.g., in eq::Image. The
  * implementation works like a pool, that is, data is only released when the
  * buffer is deleted or clear() is called.
+ *
+ * The memory is managed by the allocation policy A, see allocator.h. The
+ * default MallocAllocator uses malloc, realloc and free. If the policy fails
+ * to allocate, std::bad_alloc is thrown and the buffer keeps its contents.
  */
-template< class T > class Buffer
+template< class T, class A > class Buffer
 {
 public:
     /** Construct a new, empty buffer. @version 1.0 */
@@ -57,7 +64,9 @@ public:
     ~Buffer() { clear(); }
 
     /** Flush the buffer, deleting all data. @version 1.0 */
-    void clear() { if( _data ) free( _data ); _data=0; _size=0; _maxSize=0; }
+    void clear()
+        { A::deallocate( _data, _maxSize * sizeof( T )); _data=0; _size=0;
+          _maxSize=0; }
 
     /**
      * Tighten the allocated memory to the size of the buffer.
@@ -112,8 +121,15 @@ public:
      */
     T* reset( const uint64_t newSize );
 
-    /** Set the buffer content to 0. @version 1.9.1 */
-    void setZero() { ::lunchbox::setZero( _data, _size ); }
+    /**
+     * Set the buffer content to 0.
+     *
+     * @param parallel use multiple threads for large buffers (since 1.11),
+     *                 see parallelSetZero().
+     * @version 1.9.1
+     */
+    void setZero( const bool parallel = false )
+        { ::lunchbox::setZero( _data, getNumBytes(), parallel ); }
 
     /** Append elements to the buffer, increasing the size. @version 1.0 */
     void append( const T* data, const uint64_t size );
@@ -121,11 +137,27 @@ public:
     /** Append one element to the buffer. @version 1.0 */
     void append( const T& element );
 
-    /** Replace the existing data with new data. @version 1.0 */
-    void replace( const void* data, const uint64_t size );
+    /**
+     * Replace the existing data with new data.
+     *
+     * @param data the new elements.
+     * @param size the number of new elements.
+     * @param parallel use multiple threads to copy large data (since 1.11),
+     *                 see parallelCopy().
+     * @version 1.0
+     */
+    void replace( const void* data, const uint64_t size,
+                  const bool parallel = false );
 
-    /** Replace the existing data. @version 1.5.1 */
-    void replace( const Buffer& from ) { replace( from._data, from._size ); }
+    /**
+     * Replace the existing data.
+     *
+     * @param from the buffer to copy.
+     * @param parallel use multiple threads to copy large data (since 1.11).
+     * @version 1.5.1
+     */
+    void replace( const Buffer& from, const bool parallel = false )
+        { replace( from._data, from._size, parallel ); }
 
     /** Swap the buffer contents with another Buffer. @version 1.0 */
     void swap( Buffer& buffer );
@@ -167,6 +199,8 @@ private:
 
     /** The allocation _size of the buffer. */
     uint64_t _maxSize;
+
+    void _setAllocation( uint64_t maxSize );
 };
 }
 
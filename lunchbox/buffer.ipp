@@ -18,68 +18,57 @@
 
 namespace lunchbox
 {
-template< class T > Buffer< T >::Buffer( Buffer< T >& from )
+template< class T, class A > Buffer< T, A >::Buffer( Buffer< T, A >& from )
 {
     _data = from._data; _size = from._size; _maxSize = from._maxSize;
     from._data = 0; from._size = 0; from._maxSize = 0;
 }
 
-template< class T > T* Buffer< T >::pack()
+template< class T, class A > T* Buffer< T, A >::pack()
 {
     if( _maxSize != _size )
-    {
-        _data = static_cast< T* >( realloc( _data, _size * sizeof( T )));
-        _maxSize = _size;
-    }
+        _setAllocation( _size );
     return _data;
 }
 
-template< class T >
-Buffer< T >& Buffer< T >::operator = ( const Buffer< T >& from )
+template< class T, class A >
+Buffer< T, A >& Buffer< T, A >::operator = ( const Buffer< T, A >& from )
 {
     replace( from );
     return *this;
 }
 
-template< class T > T* Buffer< T >::resize( const uint64_t newSize )
+template< class T, class A > T* Buffer< T, A >::resize( const uint64_t newSize )
 {
+    if( newSize > _maxSize )
+        _setAllocation( newSize + (newSize >> 3) ); // avoid excessive reallocs
     _size = newSize;
-    if( newSize <= _maxSize )
-        return _data;
-
-    // avoid excessive reallocs
-    const uint64_t nElems = newSize + (newSize >> 3);
-    const uint64_t nBytes = nElems * sizeof( T );
-    _data = static_cast< T* >( realloc( _data, nBytes ));
-    _maxSize = nElems;
     return _data;
 }
 
-template< class T > void Buffer< T >::grow( const uint64_t newSize )
+template< class T, class A > void Buffer< T, A >::grow( const uint64_t newSize )
 {
     if( newSize > _size )
         resize( newSize );
 }
 
-template< class T > T* Buffer< T >::reserve( const uint64_t newSize )
+template< class T, class A >
+T* Buffer< T, A >::reserve( const uint64_t newSize )
 {
-    if( newSize <= _maxSize )
-        return _data;
-
-    _data = static_cast< T* >( realloc( _data, newSize * sizeof( T )));
-    _maxSize = newSize;
+    if( newSize > _maxSize )
+        _setAllocation( newSize );
     return _data;
 }
 
-template< class T > T* Buffer< T >::reset( const uint64_t newSize )
+template< class T, class A > T* Buffer< T, A >::reset( const uint64_t newSize )
 {
     reserve( newSize );
     setSize( newSize );
     return _data;
 }
 
-template< class T >
-void Buffer< T >::append( const T* data, const uint64_t size )
+template< class T, class A >
+void Buffer< T, A >::append( const T* data, const uint64_t size )
 {
     LBASSERT( data );
     LBASSERT( size );
@@ -89,24 +78,28 @@ void Buffer< T >::append( const T* data, const uint64_t size )
     memcpy( _data + oldSize, data, size * sizeof( T ));
 }
 
-template< class T > void Buffer< T >::append( const T& element )
+template< class T, class A > void Buffer< T, A >::append( const T& element )
 {
     resize( _size + 1 );
     _data[ _size - 1 ] = element;
 }
 
-template< class T >
-void Buffer< T >::replace( const void* data, const uint64_t size )
+template< class T, class A >
+void Buffer< T, A >::replace( const void* data, const uint64_t size,
+                              const bool parallel )
 {
     LBASSERT( data );
     LBASSERT( size );
 
     reserve( size );
-    memcpy( _data, data, size * sizeof( T ));
+    if( parallel )
+        parallelCopy( _data, data, size * sizeof( T ));
+    else
+        memcpy( _data, data, size * sizeof( T ));
     _size = size;
 }
 
-template< class T > void Buffer< T >::swap( Buffer< T >& buffer )
+template< class T, class A > void Buffer< T, A >::swap( Buffer< T, A >& buffer )
 {
     T*             tmpData    = buffer._data;
     const uint64_t tmpSize    = buffer._size;
@@ -121,7 +114,7 @@ template< class T > void Buffer< T >::swap( Buffer< T >& buffer )
     _maxSize = tmpMaxSize;
 }
 
-template< class T > bool Buffer< T >::setSize( const uint64_t size )
+template< class T, class A > bool Buffer< T, A >::setSize( const uint64_t size )
 {
     LBASSERT( size <= _maxSize );
     if( size > _maxSize )
@@ -130,4 +123,15 @@ template< class T > bool Buffer< T >::setSize( const uint64_t size )
     _size = size;
     return true;
 }
+
+template< class T, class A >
+void Buffer< T, A >::_setAllocation( const uint64_t maxSize )
+{
+    T* data = static_cast< T* >( A::reallocate( _data, _maxSize * sizeof( T ),
+                                                maxSize * sizeof( T )));
+    if( !data && maxSize > 0 )
+        throw std::bad_alloc(); // _data is still valid
+    _data = data;
+    _maxSize = maxSize;
+}
 }
@@ -0,0 +1,103 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "bufferChain.h"
+
+#include "compiler.h"
+
+namespace lunchbox
+{
+namespace
+{
+const size_t _prefetchSize = 256; // bytes prefetched per segment
+}
+
+BufferChain::BufferChain()
+    : _size( 0 )
+{}
+
+BufferChain::~BufferChain()
+{}
+
+void BufferChain::append( void* data, const uint64_t size )
+{
+    if( size == 0 )
+        return;
+
+    iovec segment;
+    segment.iov_base = data;
+    segment.iov_len = size;
+    _segments.push_back( segment );
+    _size += size;
+}
+
+void BufferChain::append( Bufferb& buffer )
+{
+    append( BufferView( buffer ));
+}
+
+void BufferChain::append( const BufferView& view )
+{
+    if( view.isEmpty( ))
+        return;
+
+    _views.push_back( view );
+    append( const_cast< uint8_t* >( view.getData( )), view.getSize( ));
+}
+
+void BufferChain::clear()
+{
+    _segments.clear();
+    _views.clear();
+    _size = 0;
+}
+
+const uint8_t* BufferChain::linearize()
+{
+    if( _segments.size() > 1 )
+    {
+        Bufferb buffer( _size );
+        copyTo( buffer.getData( ));
+        clear();
+        append( buffer );
+    }
+    return _segments.empty() ? 0 :
+                     static_cast< const uint8_t* >( _segments[0].iov_base );
+}
+
+uint64_t BufferChain::copyTo( void* to ) const
+{
+    uint8_t* ptr = static_cast< uint8_t* >( to );
+    for( size_t i = 0; i < _segments.size(); ++i )
+    {
+        if( i + 1 < _segments.size( ))
+        {
+            const iovec& next = _segments[ i + 1 ];
+            const uint8_t* nextData = static_cast< const uint8_t* >(
+                next.iov_base );
+            const size_t nextSize = std::min( next.iov_len, _prefetchSize );
+            for( size_t j = 0; j < nextSize; j += 64 )
+                LB_PREFETCH( nextData + j );
+        }
+
+        const iovec& segment = _segments[ i ];
+        ::memcpy( ptr, segment.iov_base, segment.iov_len );
+        ptr += segment.iov_len;
+    }
+    return _size;
+}
+}
@@ -0,0 +1,125 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_BUFFERCHAIN_H
+#define LUNCHBOX_BUFFERCHAIN_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/bufferView.h> // member
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+#ifndef _WIN32
+#  include <sys/uio.h>
+#endif
+
+namespace lunchbox
+{
+#ifdef _WIN32
+/** A scatter-gather element compatible with the POSIX struct iovec. */
+struct iovec
+{
+    void* iov_base;
+    size_t iov_len;
+};
+#else
+using ::iovec;
+#endif
+
+/**
+ * A sequence of memory segments for vectored I/O.
+ *
+ * Segments are either borrowed memory ranges, which have to stay valid while
+ * used by the chain, or owned data from Buffer and BufferView objects, which
+ * is kept alive by the chain. Appending a segment never copies its data.
+ *
+ * getIOVecs() returns the segments as an iovec array, which can be passed
+ * directly to writev(), readv() or pwritev(). The caller has to split chains
+ * with more than IOV_MAX segments into multiple calls. Borrowed segments are
+ * writable and can be used with readv(). Owned segments are immutable.
+ *
+ * Example: @include tests/bufferChain.cpp
+ */
+class BufferChain : public boost::noncopyable
+{
+public:
+    /** Construct a new, empty chain. @version 1.11 */
+    LUNCHBOX_API BufferChain();
+
+    /** Destruct the chain, releasing all owned segments. @version 1.11 */
+    LUNCHBOX_API ~BufferChain();
+
+    /** Append a borrowed memory range. @version 1.11 */
+    LUNCHBOX_API void append( void* data, uint64_t size );
+
+    /**
+     * Append the data of a buffer.
+     *
+     * The data is taken over without copying it, and the buffer is empty
+     * afterwards.
+     * @version 1.11
+     */
+    LUNCHBOX_API void append( Bufferb& buffer );
+
+    /** Append the data of a view, sharing its storage. @version 1.11 */
+    LUNCHBOX_API void append( const BufferView& view );
+
+    /** Remove all segments. @version 1.11 */
+    LUNCHBOX_API void clear();
+
+    /**
+     * Merge all segments into a single owned segment.
+     *
+     * Copies the data only if the chain has more than one segment.
+     * @return a pointer to the contiguous data of the chain.
+     * @version 1.11
+     */
+    LUNCHBOX_API const uint8_t* linearize();
+
+    /**
+     * Copy the data of all segments into contiguous memory.
+     *
+     * The start of each following segment is prefetched while copying the
+     * current one.
+     * @param to the destination, at least getSize() bytes.
+     * @return the number of bytes copied.
+     * @version 1.11
+     */
+    LUNCHBOX_API uint64_t copyTo( void* to ) const;
+
+    /** @return the segments as an iovec array. @version 1.11 */
+    const iovec* getIOVecs() const
+        { return _segments.empty() ? 0 : &_segments.front(); }
+
+    /** @return the number of segments. @version 1.11 */
+    size_t getNSegments() const { return _segments.size(); }
+
+    /** @return the total number of bytes of all segments. @version 1.11 */
+    uint64_t getSize() const { return _size; }
+
+    /** @return true if the chain has no data, false if not. @version 1.11 */
+    bool isEmpty() const { return _size == 0; }
+
+private:
+    std::vector< iovec > _segments;
+    std::vector< BufferView > _views; // keep owned segments alive
+    uint64_t _size;
+};
+}
+
+#endif // LUNCHBOX_BUFFERCHAIN_H
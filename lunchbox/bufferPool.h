@@ -0,0 +1,126 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_BUFFERPOOL_H
+#define LUNCHBOX_BUFFERPOOL_H
+
+#include <lunchbox/buffer.h>      // used inline
+#include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinLock.h>    // member
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace lunchbox
+{
+/**
+ * A thread-safe pool recycling large buffers.
+ *
+ * Buffers are handed out from power-of-two size classes, starting at the
+ * minimum size given at construction. A buffer allocated for a given size has
+ * the capacity of its size class, and is cached in that class when released.
+ * Since cached buffers keep their memory, reusing them avoids returning memory
+ * to the operating system and page-faulting it in again.
+ *
+ * The total capacity of all cached buffers is limited. A released buffer which
+ * would exceed the limit is deleted, and trim() deletes cached buffers,
+ * largest first, until the cached capacity is below a given number of bytes.
+ *
+ * Buffers may be released by a different thread than the one which allocated
+ * them. Buffers may also be deleted instead of being released.
+ *
+ * Example: @include tests/bufferPool.cpp
+ */
+template< class T, class A = MallocAllocator >
+class BufferPool : public boost::noncopyable
+{
+public:
+    typedef lunchbox::Buffer< T, A > Buffer; //!< The pooled buffer type
+
+    /** Pool usage statistics. @version 1.11 */
+    struct Stats
+    {
+        Stats() : nHits( 0 ), nMisses( 0 ), nDropped( 0 ), nTrimmed( 0 )
+                , nCached( 0 ), cachedBytes( 0 ) {}
+
+        size_t nHits;         //!< Allocations served from the cache
+        size_t nMisses;       //!< Allocations creating a new buffer
+        size_t nDropped;      //!< Released buffers deleted due to the limit
+        size_t nTrimmed;      //!< Cached buffers deleted by trim()
+        size_t nCached;       //!< Buffers currently cached
+        uint64_t cachedBytes; //!< Capacity of the cached buffers in bytes
+    };
+
+    /**
+     * Construct a new pool.
+     *
+     * @param maxCachedBytes the maximum capacity of all cached buffers.
+     * @param minSize the number of elements of the smallest size class.
+     * @version 1.11
+     */
+    explicit BufferPool( uint64_t maxCachedBytes = LB_1GB,
+                         uint64_t minSize = 4096 );
+
+    /** Destruct this pool and all cached buffers. @version 1.11 */
+    ~BufferPool();
+
+    /**
+     * Allocate a buffer of the given size.
+     *
+     * The content of the buffer is undefined.
+     * @return a buffer of the given size.
+     * @version 1.11
+     */
+    Buffer* alloc( uint64_t size );
+
+    /** Release a buffer for reuse. @version 1.11 */
+    void release( Buffer* buffer );
+
+    /**
+     * Delete cached buffers, largest first, until the capacity of all cached
+     * buffers is at most the given number of bytes.
+     * @version 1.11
+     */
+    void trim( uint64_t maxCachedBytes = 0 );
+
+    /** @return the current usage statistics. @version 1.11 */
+    Stats getStats() const;
+
+    /** @return the capacity of the given size class. @version 1.11 */
+    uint64_t getClassSize( const size_t index ) const
+        { return _minSize << index; }
+
+    /** @return the size class for the given size. @version 1.11 */
+    size_t getClass( uint64_t size ) const;
+
+private:
+    enum { NCLASSES = 48 };
+
+    const uint64_t _maxCachedBytes;
+    const uint64_t _minSize;
+
+    mutable SpinLock _lock; // protects all members below
+    std::vector< Buffer* > _cache[ NCLASSES ];
+    Stats _stats;
+};
+
+typedef BufferPool< uint8_t > BufferPoolb; //!< A pool of byte buffers
+}
+
+#include "bufferPool.ipp" // template implementation
+
+#endif // LUNCHBOX_BUFFERPOOL_H
@@ -0,0 +1,137 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+namespace lunchbox
+{
+template< class T, class A >
+BufferPool< T, A >::BufferPool( const uint64_t maxCachedBytes,
+                                const uint64_t minSize )
+    : _maxCachedBytes( maxCachedBytes )
+    , _minSize( minSize )
+{
+    LBASSERT( minSize > 0 );
+}
+
+template< class T, class A > BufferPool< T, A >::~BufferPool()
+{
+    trim( 0 );
+}
+
+template< class T, class A >
+size_t BufferPool< T, A >::getClass( const uint64_t size ) const
+{
+    size_t index = 0;
+    while( getClassSize( index ) < size && index < NCLASSES - 1 )
+        ++index;
+    return index;
+}
+
+template< class T, class A >
+typename BufferPool< T, A >::Buffer* BufferPool< T, A >::alloc(
+    const uint64_t size )
+{
+    const size_t index = getClass( size );
+    Buffer* buffer = 0;
+    {
+        ScopedFastWrite mutex( _lock );
+        std::vector< Buffer* >& cache = _cache[ index ];
+        if( cache.empty( ))
+            ++_stats.nMisses;
+        else
+        {
+            buffer = cache.back();
+            cache.pop_back();
+            ++_stats.nHits;
+            --_stats.nCached;
+            _stats.cachedBytes -= buffer->getMaxSize() * sizeof( T );
+        }
+    }
+
+    if( !buffer )
+    {
+        buffer = new Buffer;
+        buffer->reserve( getClassSize( index ));
+    }
+    buffer->setSize( size );
+    return buffer;
+}
+
+template< class T, class A >
+void BufferPool< T, A >::release( Buffer* buffer )
+{
+    // cache in the largest class the buffer can serve
+    const uint64_t capacity = buffer->getMaxSize();
+    size_t index = getClass( capacity );
+    if( getClassSize( index ) > capacity )
+    {
+        if( index == 0 ) // too small for the pool
+        {
+            delete buffer;
+            return;
+        }
+        --index;
+    }
+
+    const uint64_t bytes = capacity * sizeof( T );
+    {
+        ScopedFastWrite mutex( _lock );
+        if( _stats.cachedBytes + bytes <= _maxCachedBytes )
+        {
+            _cache[ index ].push_back( buffer );
+            ++_stats.nCached;
+            _stats.cachedBytes += bytes;
+            return;
+        }
+        ++_stats.nDropped;
+    }
+    delete buffer;
+}
+
+template< class T, class A >
+void BufferPool< T, A >::trim( const uint64_t maxCachedBytes )
+{
+    std::vector< Buffer* > trimmed;
+    {
+        ScopedFastWrite mutex( _lock );
+        for( size_t i = NCLASSES; i > 0 &&
+                 _stats.cachedBytes > maxCachedBytes; --i )
+        {
+            std::vector< Buffer* >& cache = _cache[ i - 1 ];
+            while( !cache.empty() && _stats.cachedBytes > maxCachedBytes )
+            {
+                Buffer* buffer = cache.back();
+                cache.pop_back();
+                trimmed.push_back( buffer );
+                ++_stats.nTrimmed;
+                --_stats.nCached;
+                _stats.cachedBytes -= buffer->getMaxSize() * sizeof( T );
+            }
+        }
+    }
+
+    // free memory outside of the lock
+    for( size_t i = 0; i < trimmed.size(); ++i )
+        delete trimmed[ i ];
+}
+
+template< class T, class A >
+typename BufferPool< T, A >::Stats BufferPool< T, A >::getStats() const
+{
+    ScopedFastWrite mutex( _lock );
+    return _stats;
+}
+}
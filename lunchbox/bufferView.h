@@ -0,0 +1,128 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_BUFFERVIEW_H
+#define LUNCHBOX_BUFFERVIEW_H
+
+#include <lunchbox/buffer.h>     // member
+#include <lunchbox/debug.h>      // LBASSERT macro
+#include <lunchbox/refPtr.h>     // member
+#include <lunchbox/referenced.h> // base class of member
+
+#include <algorithm> // std::min
+
+namespace lunchbox
+{
+/**
+ * A view on a range of immutable, reference-counted bytes.
+ *
+ * The bytes are owned by a shared storage, which is deleted when the last view
+ * referencing it is destroyed. Copying a view and creating slices of it only
+ * reference the storage, they never copy the bytes. This allows multiple
+ * consumers, e.g., a network send and a PersistentMap::insert, to hold on to
+ * the same payload.
+ *
+ * The storage is created either by taking over the data of a Buffer without
+ * copying it, or by copying a given memory range. Views can be passed between
+ * threads, but a single view is not thread-safe.
+ *
+ * Example: @include tests/bufferView.cpp
+ */
+class BufferView
+{
+public:
+    /** Construct a new, empty view. @version 1.11 */
+    BufferView() : _data( 0 ), _size( 0 ) {}
+
+    /**
+     * Construct a new view on the data of the given buffer.
+     *
+     * The data is taken over without copying it, and the buffer is empty
+     * afterwards.
+     * @version 1.11
+     */
+    explicit BufferView( Bufferb& buffer )
+        : _storage( new Storage )
+        , _data( buffer.getData( ))
+        , _size( buffer.getSize( ))
+    {
+        _storage->buffer.swap( buffer );
+    }
+
+    /** Construct a new view on a copy of the given data. @version 1.11 */
+    BufferView( const void* data, const uint64_t size )
+        : _data( 0 )
+        , _size( size )
+    {
+        if( size == 0 )
+            return;
+        _storage = new Storage;
+        _storage->buffer.replace( data, size );
+        _data = _storage->buffer.getData();
+    }
+
+    /**
+     * @return a view on a range of this view, sharing its storage.
+     * @param offset the start of the range relative to this view.
+     * @param size the size of the range, clamped to the end of this view.
+     * @version 1.11
+     */
+    BufferView getSlice( const uint64_t offset,
+                         const uint64_t size = LB_UNDEFINED_UINT64 ) const
+    {
+        LBASSERTINFO( offset <= _size, offset << " > " << _size );
+        BufferView slice( *this );
+        slice._data += offset;
+        slice._size = std::min( size, _size - offset );
+        return slice;
+    }
+
+    /** Release the reference to the storage. @version 1.11 */
+    void clear() { _storage = 0; _data = 0; _size = 0; }
+
+    /** Direct const access to a byte. @version 1.11 */
+    const uint8_t& operator [] ( const uint64_t position ) const
+        { LBASSERT( _size > position ); return _data[ position ]; }
+
+    /** @return a pointer to the first byte of this view. @version 1.11 */
+    const uint8_t* getData() const { return _data; }
+
+    /** @return the number of bytes of this view. @version 1.11 */
+    uint64_t getSize() const { return _size; }
+
+    /** @return true if the view is empty, false if not. @version 1.11 */
+    bool isEmpty() const { return _size == 0; }
+
+    /**
+     * @return true if no other view references the storage of this view.
+     * @version 1.11
+     */
+    bool isUnique() const { return !_storage || _storage->getRefCount() == 1; }
+
+private:
+    struct Storage : public Referenced
+    {
+        Bufferb buffer;
+    };
+
+    RefPtr< Storage > _storage;
+    const uint8_t* _data;
+    uint64_t _size;
+};
+}
+
+#endif // LUNCHBOX_BUFFERVIEW_H
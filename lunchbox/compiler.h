@@ -50,6 +50,7 @@
 #  define LB_UNUSED __attribute__((unused))
 #  define LB_LIKELY(x)       __builtin_expect( (x), 1 )
 #  define LB_UNLIKELY(x)     __builtin_expect( (x), 0 )
+#  define LB_PREFETCH(x)     __builtin_prefetch( (x) )
 #  ifdef WARN_DEPRECATED // Set CMake option ENABLE_WARN_DEPRECATED
 #    define LB_DEPRECATED __attribute__((deprecated))
 #  endif
@@ -134,6 +135,9 @@
 #  define LB_LIKELY(x)       x
 #  define LB_UNLIKELY(x)     x
 #endif
+#ifndef LB_PREFETCH
+#  define LB_PREFETCH(x)
+#endif
 #ifdef LB_DEPRECATED
 #  define LB_PUSH_DEPRECATED                                          \
     _Pragma("clang diagnostic push")                                  \
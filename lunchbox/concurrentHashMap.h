@@ -0,0 +1,169 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_CONCURRENTHASHMAP_H
+#define LUNCHBOX_CONCURRENTHASHMAP_H
+
+#include <lunchbox/allocator.h>   // used inline
+#include <lunchbox/debug.h>       // used inline
+#include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinLock.h>    // member
+#include <lunchbox/stdExt.h>      // member
+
+#include <boost/noncopyable.hpp>
+#include <new> // placement new
+
+namespace lunchbox
+{
+/**
+ * A thread-safe hash map using lock striping.
+ *
+ * The key space is partitioned over a fixed number of stripes, each being a
+ * stde::hash_map protected by its own SpinLock. Operations on keys hashing to
+ * different stripes proceed in parallel, lookups on the same stripe share a
+ * read lock. This replaces the common pattern of a single
+ * Lockable< stde::hash_map > for concurrent lookup tables.
+ *
+ * Values are returned by copy, since a reference into the map would not be
+ * protected after the stripe lock is released. Use update() to modify a value
+ * in place. Iteration is only supported through a snapshot() copy, which is
+ * consistent per stripe but not across stripes.
+ *
+ * Example: @include tests/concurrentHashMap.cpp
+ */
+#ifdef _MSC_VER
+template< class K, class V, class H = stde::hash_compare< K > >
+#else
+template< class K, class V, class H = stde::hash< K > >
+#endif
+class ConcurrentHashMap : public boost::noncopyable
+{
+public:
+    typedef stde::hash_map< K, V, H > Map; //!< The map type of one stripe
+    typedef K key_type;
+    typedef V mapped_type;
+
+    /**
+     * Construct a new concurrent hash map.
+     *
+     * @param nStripes the number of independently locked stripes, rounded up
+     *                 to the next power of two.
+     * @version 1.11
+     */
+    explicit ConcurrentHashMap( const size_t nStripes = 64 );
+
+    /** Destruct this hash map. @version 1.11 */
+    ~ConcurrentHashMap();
+
+    /**
+     * Look up the value of the given key.
+     *
+     * @param key the key to look up.
+     * @param value set to a copy of the value if found, unmodified otherwise.
+     * @return true if the key was found, false otherwise.
+     * @version 1.11
+     */
+    bool find( const K& key, V& value ) const;
+
+    /** @return true if the given key is in the map. @version 1.11 */
+    bool contains( const K& key ) const;
+
+    /**
+     * Insert a new key-value pair.
+     *
+     * @return true if the value was inserted, false if the key already exists.
+     * @version 1.11
+     */
+    bool insert( const K& key, const V& value );
+
+    /**
+     * Insert or overwrite a key-value pair.
+     *
+     * @return true if the value was inserted, false if it was overwritten.
+     * @version 1.11
+     */
+    bool set( const K& key, const V& value );
+
+    /**
+     * Remove the given key.
+     *
+     * @return true if the key was erased, false if it was not in the map.
+     * @version 1.11
+     */
+    bool erase( const K& key );
+
+    /**
+     * Remove the given key and retrieve its value.
+     *
+     * @return true if the key was erased, false if it was not in the map.
+     * @version 1.11
+     */
+    bool erase( const K& key, V& value );
+
+    /**
+     * Modify the value of the given key in place.
+     *
+     * The functor is called as func( V& ) while holding the stripe lock
+     * exclusively. It should be short and must not access this map.
+     *
+     * @return true if the key was found and updated, false otherwise.
+     * @version 1.11
+     */
+    template< class F > bool update( const K& key, F func );
+
+    /** @return the number of elements in the map. @version 1.11 */
+    size_t size() const;
+
+    /** @return true if the map has no elements. @version 1.11 */
+    bool empty() const;
+
+    /** Remove all elements from the map. @version 1.11 */
+    void clear();
+
+    /**
+     * @return a copy of all elements, each stripe being copied atomically.
+     * @version 1.11
+     */
+    Map snapshot() const;
+
+    /** @return the number of stripes. @version 1.11 */
+    size_t getNStripes() const { return _mask + 1; }
+
+private:
+    struct Stripe
+    {
+        mutable SpinLock lock;
+        Map map;
+    };
+
+    enum { _lineSize = 64 };
+    typedef AlignedAllocator< _lineSize > Allocator;
+
+    const size_t _mask;
+    const size_t _stride; // bytes per stripe, a multiple of the cache line
+    char* _stripes;       // each stripe starts on its own cache line
+
+    static size_t _roundUpPowerOfTwo( size_t value );
+    Stripe& _getStripeAt( size_t index ) const;
+    Stripe& _getStripe( const K& key );
+    const Stripe& _getStripe( const K& key ) const;
+};
+}
+
+#include "concurrentHashMap.ipp" // template implementation
+
+#endif // LUNCHBOX_CONCURRENTHASHMAP_H
@@ -0,0 +1,201 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+namespace lunchbox
+{
+template< class K, class V, class H >
+ConcurrentHashMap< K, V, H >::ConcurrentHashMap( const size_t nStripes )
+    : _mask( _roundUpPowerOfTwo( LB_MAX( nStripes, size_t( 1 ))) - 1 )
+    , _stride(( sizeof( Stripe ) + _lineSize - 1 ) & ~size_t( _lineSize - 1 ))
+    , _stripes( static_cast< char* >(
+                    Allocator::allocate( ( _mask + 1 ) * _stride )))
+{
+    if( !_stripes )
+        throw std::bad_alloc();
+    for( size_t i = 0; i <= _mask; ++i )
+        new( _stripes + i * _stride ) Stripe;
+}
+
+template< class K, class V, class H >
+ConcurrentHashMap< K, V, H >::~ConcurrentHashMap()
+{
+    for( size_t i = 0; i <= _mask; ++i )
+        _getStripeAt( i ).~Stripe();
+    Allocator::deallocate( _stripes, ( _mask + 1 ) * _stride );
+}
+
+template< class K, class V, class H >
+size_t ConcurrentHashMap< K, V, H >::_roundUpPowerOfTwo( const size_t value )
+{
+    size_t result = 1;
+    while( result < value )
+        result <<= 1;
+    return result;
+}
+
+template< class K, class V, class H > typename
+ConcurrentHashMap< K, V, H >::Stripe&
+ConcurrentHashMap< K, V, H >::_getStripeAt( const size_t index ) const
+{
+    LBASSERT( index <= _mask );
+    return *reinterpret_cast< Stripe* >( _stripes + index * _stride );
+}
+
+template< class K, class V, class H > typename
+ConcurrentHashMap< K, V, H >::Stripe&
+ConcurrentHashMap< K, V, H >::_getStripe( const K& key )
+{
+    size_t hash = H()( key );
+    // the stripe map uses the low bits of the same hash for its buckets
+    hash ^= ( hash >> 16 ) ^ ( hash >> 7 );
+    return _getStripeAt( hash & _mask );
+}
+
+template< class K, class V, class H > const typename
+ConcurrentHashMap< K, V, H >::Stripe&
+ConcurrentHashMap< K, V, H >::_getStripe( const K& key ) const
+{
+    return const_cast< ConcurrentHashMap* >( this )->_getStripe( key );
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::find( const K& key, V& value ) const
+{
+    const Stripe& stripe = _getStripe( key );
+    ScopedFastRead mutex( stripe.lock );
+    typename Map::const_iterator i = stripe.map.find( key );
+    if( i == stripe.map.end( ))
+        return false;
+
+    value = i->second;
+    return true;
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::contains( const K& key ) const
+{
+    const Stripe& stripe = _getStripe( key );
+    ScopedFastRead mutex( stripe.lock );
+    return stripe.map.find( key ) != stripe.map.end();
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::insert( const K& key, const V& value )
+{
+    Stripe& stripe = _getStripe( key );
+    ScopedFastWrite mutex( stripe.lock );
+    return stripe.map.insert( std::make_pair( key, value )).second;
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::set( const K& key, const V& value )
+{
+    Stripe& stripe = _getStripe( key );
+    ScopedFastWrite mutex( stripe.lock );
+    std::pair< typename Map::iterator, bool > result =
+        stripe.map.insert( std::make_pair( key, value ));
+    if( !result.second )
+        result.first->second = value;
+    return result.second;
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::erase( const K& key )
+{
+    Stripe& stripe = _getStripe( key );
+    ScopedFastWrite mutex( stripe.lock );
+    return stripe.map.erase( key ) > 0;
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::erase( const K& key, V& value )
+{
+    Stripe& stripe = _getStripe( key );
+    ScopedFastWrite mutex( stripe.lock );
+    typename Map::iterator i = stripe.map.find( key );
+    if( i == stripe.map.end( ))
+        return false;
+
+    value = i->second;
+    stripe.map.erase( i );
+    return true;
+}
+
+template< class K, class V, class H > template< class F >
+bool ConcurrentHashMap< K, V, H >::update( const K& key, F func )
+{
+    Stripe& stripe = _getStripe( key );
+    ScopedFastWrite mutex( stripe.lock );
+    typename Map::iterator i = stripe.map.find( key );
+    if( i == stripe.map.end( ))
+        return false;
+
+    func( i->second );
+    return true;
+}
+
+template< class K, class V, class H >
+size_t ConcurrentHashMap< K, V, H >::size() const
+{
+    size_t result = 0;
+    for( size_t i = 0; i <= _mask; ++i )
+    {
+        const Stripe& stripe = _getStripeAt( i );
+        ScopedFastRead mutex( stripe.lock );
+        result += stripe.map.size();
+    }
+    return result;
+}
+
+template< class K, class V, class H >
+bool ConcurrentHashMap< K, V, H >::empty() const
+{
+    for( size_t i = 0; i <= _mask; ++i )
+    {
+        const Stripe& stripe = _getStripeAt( i );
+        ScopedFastRead mutex( stripe.lock );
+        if( !stripe.map.empty( ))
+            return false;
+    }
+    return true;
+}
+
+template< class K, class V, class H >
+void ConcurrentHashMap< K, V, H >::clear()
+{
+    for( size_t i = 0; i <= _mask; ++i )
+    {
+        Stripe& stripe = _getStripeAt( i );
+        ScopedFastWrite mutex( stripe.lock );
+        stripe.map.clear();
+    }
+}
+
+template< class K, class V, class H > typename
+ConcurrentHashMap< K, V, H >::Map
+ConcurrentHashMap< K, V, H >::snapshot() const
+{
+    Map result;
+    for( size_t i = 0; i <= _mask; ++i )
+    {
+        const Stripe& stripe = _getStripeAt( i );
+        ScopedFastRead mutex( stripe.lock );
+        result.insert( stripe.map.begin(), stripe.map.end( ));
+    }
+    return result;
+}
+}
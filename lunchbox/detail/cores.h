@@ -0,0 +1,31 @@
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_DETAIL_CORES_H
+#define LUNCHBOX_DETAIL_CORES_H
+
+#include <lunchbox/types.h>
+
+namespace lunchbox
+{
+namespace detail
+{
+/** @return the number of online processors, at least one. */
+size_t getNCores();
+}
+}
+
+#endif // LUNCHBOX_DETAIL_CORES_H
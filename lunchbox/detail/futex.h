@@ -0,0 +1,72 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_DETAIL_FUTEX_H
+#define LUNCHBOX_DETAIL_FUTEX_H
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/types.h>
+
+namespace lunchbox
+{
+namespace detail
+{
+/**
+ * Block while the given word has the expected value.
+ *
+ * Uses a futex on Linux and a table of condition variables elsewhere. The
+ * call may return spuriously, callers have to re-check their condition.
+ *
+ * @return false on timeout, true otherwise.
+ */
+bool futexWait( int32_t* word, int32_t expected, uint32_t timeout );
+
+/** Wake up to count threads blocked on the given word. */
+void futexWake( int32_t* word, int32_t count );
+
+/** @return the current value of a word modified by atomic operations. */
+inline int32_t load( const int32_t& word )
+{
+    const int32_t value = *const_cast< const volatile int32_t* >( &word );
+    memoryBarrierAcquire();
+    return value;
+}
+
+/** Tracks the remaining time of a timeout over multiple waits. */
+class Deadline
+{
+public:
+    explicit Deadline( const uint32_t timeout ) : _timeout( timeout ) {}
+
+    /** @return the remaining milliseconds, 0 when expired. */
+    uint32_t getRemaining() const
+    {
+        if( _timeout == LB_TIMEOUT_INDEFINITE )
+            return LB_TIMEOUT_INDEFINITE;
+        const int64_t elapsed = _clock.getTime64();
+        return elapsed >= _timeout ? 0 : uint32_t( _timeout - elapsed );
+    }
+
+private:
+    const uint32_t _timeout;
+    const lunchbox::Clock _clock;
+};
+}
+}
+
+#endif // LUNCHBOX_DETAIL_FUTEX_H
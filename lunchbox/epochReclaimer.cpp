@@ -0,0 +1,303 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "epochReclaimer.h"
+
+#include "allocator.h"
+#include "atomic.h"
+#include "tls.h"
+
+#include <new>
+
+namespace lunchbox
+{
+namespace
+{
+/** Slot indices of the last guard of each thread, plus one. */
+struct Hints
+{
+    Hints() : slot( 0 ), next( 0 ) {}
+
+    TLS slot;
+    a_int32_t next; // spreads new threads over the slots
+};
+
+// Never destroyed, since guards may be used during static destruction
+Hints& _getHints()
+{
+    static Hints* hints = new Hints;
+    return *hints;
+}
+}
+
+namespace detail
+{
+/** The epoch announced by one guard, alone in its cache line. */
+struct EpochSlot
+{
+    enum { FREE = -1 }; // not used by a guard
+
+    EpochSlot() : epoch( FREE ), padding() {}
+
+    a_ssize_t epoch;
+    char padding[ 64 - sizeof( a_ssize_t ) ];
+};
+
+/** A cache-line aligned set of slots, freed with the reclaimer. */
+struct EpochChunk
+{
+    enum { SIZE = 32 };
+
+    EpochChunk() : next( 0 ) {}
+
+    EpochSlot slots[ SIZE ];
+    EpochChunk* next;
+};
+
+class EpochReclaimer
+{
+    typedef AlignedAllocator< 64 > Allocator;
+
+public:
+    EpochReclaimer()
+        : epoch( 0 )
+        , collecting( 0 )
+        , nChunks( 1 )
+        , chunks( _newChunk( ))
+    {
+        retired[0] = retired[1] = retired[2] = 0;
+        _getHints(); // initialize before threads use guards
+    }
+
+    ~EpochReclaimer()
+    {
+        for( size_t i = 0; i < 3; ++i )
+            _delete( retired[ i ] );
+        for( EpochChunk* chunk = chunks; chunk; )
+        {
+            EpochChunk* next = chunk->next;
+            chunk->~EpochChunk();
+            Allocator::deallocate( chunk, sizeof( EpochChunk ));
+            chunk = next;
+        }
+    }
+
+    /** Claim a free slot, starting at the given index, and announce. */
+    EpochSlot* enter( size_t& index )
+    {
+        for( ;; )
+        {
+            const size_t capacity = size_t( int32_t( nChunks )) *
+                                    EpochChunk::SIZE;
+            for( size_t i = 0; i < capacity; ++i )
+            {
+                const size_t candidate = ( index + i ) % capacity;
+                EpochSlot& slot = _getSlot( candidate );
+                if( ssize_t( slot.epoch ) == EpochSlot::FREE &&
+                    slot.epoch.compareAndSwap( EpochSlot::FREE, epoch ))
+                {
+                    index = candidate;
+                    _announce( slot );
+                    return &slot;
+                }
+            }
+            _grow( capacity );
+        }
+    }
+
+    void retire( Retired* object )
+    {
+        Retired*& bucket = retired[ size_t( ssize_t( epoch ) % 3 ) ];
+        do
+            object->next = bucket;
+        while( !Atomic< Retired* >::compareAndSwap( &bucket, object->next,
+                                                    object ));
+    }
+
+    bool collect()
+    {
+        // Serialize collectors, a delayed collector could otherwise delete a
+        // bucket refilled after later epoch advances
+        if( !collecting.compareAndSwap( 0, 1 ))
+            return false;
+
+        // All guards have to announce the current epoch before advancing,
+        // then objects retired two epochs ago are not referenced anymore.
+        const ssize_t current = epoch;
+        if( !_isQuiescent( current ))
+        {
+            collecting = 0;
+            return false;
+        }
+        epoch = current + 1;
+        memoryBarrier(); // order the epoch before the slots of later scans
+
+        // Only guards from current and current+1 remain, delete the bucket of
+        // current-1, which is the bucket of the future current+2
+        Retired*& bucket = retired[ size_t(( current + 2 ) % 3 ) ];
+        Retired* list = bucket;
+        while( !Atomic< Retired* >::compareAndSwap( &bucket, list, 0 ))
+            list = bucket;
+        collecting = 0;
+
+        _delete( list );
+        return true;
+    }
+
+    bool flush()
+    {
+        // each advance deletes the bucket of one epoch
+        for( size_t i = 0; i < 3 && !_isEmpty(); ++i )
+            if( !collect( ))
+                return false;
+        return _isEmpty();
+    }
+
+    a_ssize_t epoch;
+    a_int32_t collecting;
+    a_int32_t nChunks;
+    EpochChunk* const chunks; // grows by appending, only
+    Retired* retired[3];
+
+private:
+    static EpochChunk* _newChunk()
+    {
+        void* memory = Allocator::allocate( sizeof( EpochChunk ));
+        if( !memory )
+            throw std::bad_alloc();
+        return new( memory ) EpochChunk;
+    }
+
+    static EpochChunk* _next( EpochChunk* chunk )
+        { return *static_cast< EpochChunk* volatile* >( &chunk->next ); }
+
+    EpochSlot& _getSlot( const size_t index )
+    {
+        EpochChunk* chunk = chunks;
+        for( size_t i = index / EpochChunk::SIZE; i > 0; --i )
+            chunk = _next( chunk );
+        return chunk->slots[ index % EpochChunk::SIZE ];
+    }
+
+    void _grow( const size_t capacity )
+    {
+        if( size_t( int32_t( nChunks )) * EpochChunk::SIZE > capacity )
+            return; // grown by another thread
+
+        EpochChunk* chunk = _newChunk();
+        EpochChunk* last = chunks;
+        for( ;; )
+        {
+            while( EpochChunk* next = _next( last ))
+                last = next;
+            if( Atomic< EpochChunk* >::compareAndSwap( &last->next, 0, chunk ))
+                break;
+        }
+        ++nChunks;
+    }
+
+    /** Re-announce until the epoch is stable after writing the slot. */
+    void _announce( EpochSlot& slot )
+    {
+        // A collector either sees the slot, or this guard sees its epoch
+        ssize_t announced = slot.epoch;
+        for( ;; )
+        {
+            memoryBarrier();
+            const ssize_t current = epoch;
+            if( current == announced )
+                return;
+            slot.epoch = current;
+            announced = current;
+        }
+    }
+
+    bool _isQuiescent( const ssize_t current )
+    {
+        for( EpochChunk* chunk = chunks; chunk; chunk = _next( chunk ))
+        {
+            for( size_t i = 0; i < EpochChunk::SIZE; ++i )
+            {
+                const ssize_t announced = chunk->slots[ i ].epoch;
+                if( announced != EpochSlot::FREE && announced != current )
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool _isEmpty() const
+    {
+        return !retired[0] && !retired[1] && !retired[2];
+    }
+
+    static void _delete( Retired* list )
+    {
+        while( list )
+        {
+            Retired* next = list->next;
+            delete list;
+            list = next;
+        }
+    }
+};
+}
+
+EpochReclaimer::EpochReclaimer()
+    : _impl( new detail::EpochReclaimer )
+{}
+
+EpochReclaimer::~EpochReclaimer()
+{
+    delete _impl;
+}
+
+bool EpochReclaimer::collect()
+{
+    return _impl->collect();
+}
+
+bool EpochReclaimer::flush()
+{
+    return _impl->flush();
+}
+
+detail::EpochSlot* EpochReclaimer::_enter() const
+{
+    Hints& hints = _getHints();
+    const size_t hint = reinterpret_cast< size_t >( hints.slot.get( ));
+    // the first guard of a thread starts at a new index
+    size_t index = hint > 0 ? hint - 1 : size_t( hints.next++ );
+
+    detail::EpochSlot* slot = _impl->enter( index );
+    if( index + 1 != hint )
+        hints.slot.set( reinterpret_cast< const void* >( index + 1 ));
+    return slot;
+}
+
+void EpochReclaimer::_leave( detail::EpochSlot* slot )
+{
+    memoryBarrierRelease(); // order the guarded reads before leaving
+    slot->epoch = detail::EpochSlot::FREE;
+}
+
+void EpochReclaimer::_retire( detail::Retired* retired )
+{
+    _impl->retire( retired );
+    _impl->collect();
+}
+}
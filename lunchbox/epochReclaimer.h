@@ -0,0 +1,122 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_EPOCHRECLAIMER_H
+#define LUNCHBOX_EPOCHRECLAIMER_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+namespace detail
+{
+class EpochReclaimer;
+struct EpochSlot;
+
+/** @internal A retired object, deleted through its virtual destructor. */
+struct Retired
+{
+    Retired() : next( 0 ) {}
+    virtual ~Retired() {}
+    Retired* next;
+};
+}
+
+/**
+ * Deferred deletion of objects shared with lock-free readers.
+ *
+ * Readers access shared objects only while holding a Guard. Writers unlink an
+ * object from the shared data structure and retire() it. A retired object is
+ * deleted once all guards which might still reference it have been released.
+ *
+ * The reclaimer maintains a global epoch. Each guard announces the epoch it
+ * entered in a slot of its own, padded to a cache line. Threads reuse the
+ * slot of their previous guard, so that guards of different threads do not
+ * write to shared cache lines. Retired objects are collected in one list per
+ * epoch. The epoch advances once no guard announces the previous epoch, at
+ * which point the objects retired two epochs ago are deleted. Guards are
+ * cheap and never block, but a long-lived guard delays all deletions.
+ *
+ * All methods are thread-safe.
+ */
+class EpochReclaimer : public boost::noncopyable
+{
+public:
+    /** Protects all objects reachable during its lifetime. @version 1.11 */
+    class Guard : public boost::noncopyable
+    {
+    public:
+        explicit Guard( const EpochReclaimer& reclaimer )
+            : _slot( reclaimer._enter( )) {}
+        ~Guard() { EpochReclaimer::_leave( _slot ); }
+
+    private:
+        detail::EpochSlot* const _slot;
+    };
+
+    /** Construct a new reclaimer. @version 1.11 */
+    LUNCHBOX_API EpochReclaimer();
+
+    /** Destruct the reclaimer and delete all retired objects. @version 1.11 */
+    LUNCHBOX_API ~EpochReclaimer();
+
+    /**
+     * Delete the given object once no guard references it anymore.
+     *
+     * The object has to be unreachable for new guards.
+     * @version 1.11
+     */
+    template< class T > void retire( T* object )
+        { _retire( new RetiredObject< T >( object )); }
+
+    /**
+     * Try to advance the epoch and delete objects no longer referenced.
+     *
+     * @return true if the epoch was advanced, false otherwise.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool collect();
+
+    /**
+     * Delete all retired objects which are no longer referenced.
+     *
+     * Advances the epoch as far as the current guards permit.
+     * @return true if no retired object remains.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool flush();
+
+private:
+    template< class T > struct RetiredObject : public detail::Retired
+    {
+        explicit RetiredObject( T* object_ ) : object( object_ ) {}
+        virtual ~RetiredObject() { delete object; }
+        T* const object;
+    };
+
+    detail::EpochReclaimer* const _impl;
+
+    LUNCHBOX_API detail::EpochSlot* _enter() const;
+    LUNCHBOX_API static void _leave( detail::EpochSlot* slot );
+    LUNCHBOX_API void _retire( detail::Retired* retired );
+};
+}
+
+#endif // LUNCHBOX_EPOCHRECLAIMER_H
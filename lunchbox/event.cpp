@@ -0,0 +1,96 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "event.h"
+
+#include "debug.h"
+#include "detail/futex.h"
+
+#include <limits>
+
+namespace lunchbox
+{
+namespace
+{
+typedef Atomic< int32_t > Ops;
+static const int32_t _unset = 0;
+static const int32_t _set = 1;
+}
+
+Event::Event( const Mode mode, const bool set_ )
+    : _mode( mode )
+    , _state( set_ ? _set : _unset )
+    , _nWaiters( 0 )
+{}
+
+Event::~Event()
+{
+    LBASSERTINFO( _nWaiters == 0, _nWaiters << " threads waiting" );
+}
+
+void Event::set()
+{
+    if( !Ops::compareAndSwap( &_state, _unset, _set ))
+        return; // already set
+
+    // The atomic update orders the state before reading the waiters, which
+    // count themselves before reading the state.
+    if( detail::load( _nWaiters ) > 0 )
+        detail::futexWake( &_state, _mode == AUTO_RESET ? 1 :
+                                    std::numeric_limits< int32_t >::max( ));
+}
+
+void Event::reset()
+{
+    Ops::compareAndSwap( &_state, _set, _unset );
+}
+
+bool Event::wait( const uint32_t timeout )
+{
+    if( _tryWait( ))
+        return true;
+
+    const detail::Deadline deadline( timeout );
+    Ops::incAndGet( _nWaiters );
+    bool signaled = true;
+    while( !_tryWait( ))
+    {
+        const uint32_t remaining = deadline.getRemaining();
+        if( remaining == 0 ||
+            !detail::futexWait( &_state, _unset, remaining ))
+        {
+            signaled = _tryWait();
+            break;
+        }
+    }
+    Ops::decAndGet( _nWaiters );
+    return signaled;
+}
+
+bool Event::isSet() const
+{
+    return detail::load( _state ) == _set;
+}
+
+bool Event::_tryWait()
+{
+    if( _mode == MANUAL_RESET )
+        return isSet();
+    return Ops::compareAndSwap( &_state, _set, _unset );
+}
+
+}
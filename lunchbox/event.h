@@ -0,0 +1,91 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_EVENT_H
+#define LUNCHBOX_EVENT_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * An event which threads can wait on until it is set.
+ *
+ * An AUTO_RESET event releases a single waiting thread per set(), and is
+ * reset by the released thread. A MANUAL_RESET event releases all waiting
+ * threads and stays set until reset() is called. Setting and testing the
+ * event are lock-free, and set() only wakes threads if any are blocked.
+ *
+ * Example: @include tests/event.cpp
+ */
+class Event : public boost::noncopyable
+{
+public:
+    /** The reset behaviour of the event. @version 1.11 */
+    enum Mode
+    {
+        AUTO_RESET,  //!< Reset by the single thread released by a wait
+        MANUAL_RESET //!< Stays set until reset() is called
+    };
+
+    /**
+     * Construct a new event.
+     *
+     * @param mode the reset behaviour.
+     * @param set the initial state.
+     * @version 1.11
+     */
+    LUNCHBOX_API explicit Event( Mode mode = AUTO_RESET, bool set = false );
+
+    /** Destruct the event. No thread may wait on it. @version 1.11 */
+    LUNCHBOX_API ~Event();
+
+    /** Set the event, releasing waiting threads. @version 1.11 */
+    LUNCHBOX_API void set();
+
+    /** Reset the event. @version 1.11 */
+    LUNCHBOX_API void reset();
+
+    /**
+     * Wait for the event to be set.
+     *
+     * An AUTO_RESET event is reset by the returning thread.
+     * @param timeout the timeout in milliseconds.
+     * @return true if the event was set, false on timeout.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool wait( uint32_t timeout = LB_TIMEOUT_INDEFINITE );
+
+    /** @return true if the event is set. @version 1.11 */
+    LUNCHBOX_API bool isSet() const;
+
+    /** @return the reset behaviour of the event. @version 1.11 */
+    Mode getMode() const { return _mode; }
+
+private:
+    const Mode _mode;
+    int32_t _state;
+    int32_t _nWaiters;
+
+    bool _tryWait();
+};
+}
+
+#endif // LUNCHBOX_EVENT_H
@@ -0,0 +1,50 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_EXECUTOR_H
+#define LUNCHBOX_EXECUTOR_H
+
+#include <boost/function/function0.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * Interface for objects running tasks.
+ *
+ * Used by Future::then() to schedule continuations outside of the thread
+ * fulfilling a future.
+ */
+class Executor : public boost::noncopyable
+{
+public:
+    typedef boost::function< void() > Task; //!< A unit of work @version 1.11
+
+    /** Destruct the executor. @version 1.11 */
+    virtual ~Executor() {}
+
+    /**
+     * Schedule the given task for execution.
+     *
+     * The task may be run at any later time from any thread.
+     * @version 1.11
+     */
+    virtual void post( const Task& task ) = 0;
+};
+}
+
+#endif // LUNCHBOX_EXECUTOR_H
@@ -4,26 +4,45 @@
 set(LUNCHBOX_PUBLIC_HEADERS
   ${COMMON_INCLUDES}
   algorithm.h
+  allocator.h
   any.h
   anySerialization.h
+  arena.h
   array.h
+  async.h
   atomic.h
+  barrier.h
   bitOperation.h
   buffer.h
   buffer.ipp
+  bufferChain.h
+  bufferPool.h
+  bufferPool.ipp
+  bufferView.h
   clock.h
   compiler.h
+  concurrentHashMap.h
+  concurrentHashMap.ipp
   condition.h
   daemon.h
   debug.h
   dso.h
+  epochReclaimer.h
+  event.h
+  executor.h
   file.h
+  flatUUIDHash.h
+  flatUUIDHash.ipp
   future.h
+  future.ipp
   futureFunction.h
   hash.h
   indexIterator.h
   init.h
+  latch.h
   launcher.h
+  lfPool.h
+  lfPool.ipp
   lfQueue.h
   lfQueue.ipp
   lfVector.h
@@ -32,6 +51,8 @@ set(LUNCHBOX_PUBLIC_HEADERS
   lock.h
   lockable.h
   log.h
+  magazinePool.h
+  magazinePool.ipp
   memoryMap.h
   monitor.h
   mpi.h
@@ -40,6 +61,7 @@ set(LUNCHBOX_PUBLIC_HEADERS
   nonCopyable.h
   omp.h
   os.h
+  parallelMemory.h
   perThread.h
   perThread.ipp
   perThreadRef.h
@@ -49,6 +71,7 @@ set(LUNCHBOX_PUBLIC_HEADERS
   pluginFactory.ipp
   pluginRegisterer.h
   pool.h
+  promise.h
   readyFuture.h
   refPtr.h
   referenced.h
@@ -57,13 +80,25 @@ set(LUNCHBOX_PUBLIC_HEADERS
   result.h
   rng.h
   scopedMutex.h
+  semaphore.h
   serializable.h
   servus.h
+  skipListMap.h
+  skipListMap.ipp
+  slabPool.h
+  slabPool.ipp
   sleep.h
+  slotMap.h
+  slotMap.ipp
+  smallBuffer.h
+  smallBuffer.ipp
+  snapshot.h
   spinLock.h
+  spinWait.h
   stdExt.h
   thread.h
   threadID.h
+  threadPool.h
   timedLock.h
   tls.h
   types.h
@@ -80,6 +115,8 @@ endif()
 
 set(LUNCHBOX_HEADERS
   avahi/servus.h
+  detail/cores.h
+  detail/futex.h
   detail/threadID.h
   dnssd/servus.h
   leveldb/persistentMap.h
@@ -90,15 +127,23 @@ set(LUNCHBOX_HEADERS
 
 set(LUNCHBOX_SOURCES
   ${COMMON_SOURCES}
+  allocator.cpp
   any.cpp
+  arena.cpp
   atomic.cpp
+  barrier.cpp
+  bufferChain.cpp
   clock.cpp
   condition.cpp
   condition_w32.ipp
   debug.cpp
   dso.cpp
+  epochReclaimer.cpp
+  event.cpp
   file.cpp
+  futex.cpp
   init.cpp
+  latch.cpp
   launcher.cpp
   lock.cpp
   log.cpp
@@ -107,15 +152,19 @@ set(LUNCHBOX_SOURCES
   mpi.cpp
   omp.cpp
   os.cpp
+  parallelMemory.cpp
   persistentMap.cpp
   referenced.cpp
   requestHandler.cpp
   rng.cpp
+  semaphore.cpp
   servus.cpp
   sleep.cpp
   spinLock.cpp
+  spinWait.cpp
   thread.cpp
   threadID.cpp
+  threadPool.cpp
   timedLock.cpp
   tls.cpp
   uint128_t.cpp
@@ -0,0 +1,210 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_FLATUUIDHASH_H
+#define LUNCHBOX_FLATUUIDHASH_H
+
+#include <lunchbox/debug.h>     // used inline
+#include <lunchbox/uint128_t.h> // key type
+
+#include <iterator>
+#include <utility>
+
+namespace lunchbox
+{
+/**
+ * An open-addressing hash map for uint128_t keys.
+ *
+ * The keys and values are stored in one flat array, using a parallel array of
+ * one control byte per slot. The control byte holds seven bits of the hash of a
+ * used slot, or marks it empty or deleted. Lookups compare a group of sixteen
+ * control bytes at once, using SSE2 where available, and only touch slots whose
+ * hash bits match. The hash function folds the high into the low word and
+ * mixes all bits using the MurmurHash3 finalizer. Random UUIDs would not need
+ * the mixing, but other keys, e.g., sequential keys or keys differing only in
+ * their upper bits, would otherwise collide in the same groups.
+ *
+ * In contrast to UUIDHash, inserting does not allocate unless the table grows,
+ * and lookups do not chase pointers. Insertion may move elements, which
+ * invalidates all iterators and pointers into the map. The maximum load factor
+ * is 7/8, use reserve() to avoid rehashing when the final size is known.
+ *
+ * Not thread-safe. Not all std::map methods are implemented.
+ *
+ * Example: @include tests/flatUUIDHash.cpp
+ */
+template< class T > class FlatUUIDHash
+{
+public:
+    typedef uint128_t key_type;
+    typedef T mapped_type;
+    typedef std::pair< const uint128_t, T > value_type;
+
+    class const_iterator;
+
+    /** Iterator over the map elements. @version 1.11 */
+    class iterator : public std::iterator< std::forward_iterator_tag,
+                                           value_type >
+    {
+    public:
+        iterator() : _map( 0 ), _index( 0 ) {}
+        value_type& operator*() const { return _map->_slots[ _index ]; }
+        value_type* operator->() const { return &_map->_slots[ _index ]; }
+        iterator& operator++()
+            { _index = _map->_next( _index + 1 ); return *this; }
+        bool operator == ( const iterator& rhs ) const
+            { return _index == rhs._index && _map == rhs._map; }
+        bool operator != ( const iterator& rhs ) const
+            { return !(*this == rhs); }
+
+    private:
+        friend class FlatUUIDHash;
+        friend class const_iterator;
+        iterator( FlatUUIDHash* map, const size_t index )
+            : _map( map ), _index( index ) {}
+        FlatUUIDHash* _map;
+        size_t _index;
+    };
+
+    /** Iterator over the const map elements. @version 1.11 */
+    class const_iterator : public std::iterator< std::forward_iterator_tag,
+                                                 const value_type >
+    {
+    public:
+        const_iterator() : _map( 0 ), _index( 0 ) {}
+        const_iterator( const iterator& from )
+            : _map( from._map ), _index( from._index ) {}
+        const value_type& operator*() const { return _map->_slots[ _index ]; }
+        const value_type* operator->() const
+            { return &_map->_slots[ _index ]; }
+        const_iterator& operator++()
+            { _index = _map->_next( _index + 1 ); return *this; }
+        bool operator == ( const const_iterator& rhs ) const
+            { return _index == rhs._index && _map == rhs._map; }
+        bool operator != ( const const_iterator& rhs ) const
+            { return !(*this == rhs); }
+
+    private:
+        friend class FlatUUIDHash;
+        const_iterator( const FlatUUIDHash* map, const size_t index )
+            : _map( map ), _index( index ) {}
+        const FlatUUIDHash* _map;
+        size_t _index;
+    };
+
+    /** Construct a new, empty map without allocating. @version 1.11 */
+    FlatUUIDHash();
+
+    /** Construct a copy of another map. @version 1.11 */
+    FlatUUIDHash( const FlatUUIDHash& from );
+
+    /** Destruct this map. @version 1.11 */
+    ~FlatUUIDHash();
+
+    /** Assign the elements of another map. @version 1.11 */
+    FlatUUIDHash& operator = ( const FlatUUIDHash& from );
+
+    /** @return the element for the given key, or end(). @version 1.11 */
+    iterator find( const uint128_t& key );
+
+    /** @return the element for the given key, or end(). @version 1.11 */
+    const_iterator find( const uint128_t& key ) const;
+
+    /** @return 1 if the key is in the map, 0 otherwise. @version 1.11 */
+    size_t count( const uint128_t& key ) const
+        { return _find( key ) == _capacity ? 0 : 1; }
+
+    /**
+     * Insert a new element, unless the key already exists.
+     *
+     * @return the position of the element with the key, and true if the
+     *         element was inserted.
+     * @version 1.11
+     */
+    std::pair< iterator, bool > insert( const value_type& value );
+
+    /**
+     * @return the element for the given key, default-constructing a new one
+     *         if needed.
+     * @version 1.11
+     */
+    T& operator[]( const uint128_t& key );
+
+    /** @return the number of elements erased, 0 or 1. @version 1.11 */
+    size_t erase( const uint128_t& key );
+
+    /** Erase the element at the given position. @version 1.11 */
+    void erase( iterator i );
+
+    /** Remove all elements, retaining the allocated capacity. @version 1.11*/
+    void clear();
+
+    /**
+     * Allocate enough capacity for the given number of elements.
+     *
+     * Inserting up to this number of elements will not rehash the map.
+     * @version 1.11
+     */
+    void reserve( const size_t size );
+
+    /**
+     * Rebuild the table for at least the given number of elements.
+     *
+     * Also removes all deleted markers left by erase(). rehash( 0 ) shrinks the
+     * map to the smallest capacity holding the current elements.
+     * @version 1.11
+     */
+    void rehash( const size_t size );
+
+    /** @return the number of elements. @version 1.11 */
+    size_t size() const { return _size; }
+
+    /** @return true if the map holds no elements. @version 1.11 */
+    bool empty() const { return _size == 0; }
+
+    /** @return the number of allocated slots. @version 1.11 */
+    size_t getCapacity() const { return _capacity; }
+
+    iterator begin() { return iterator( this, _next( 0 )); } //!< @version 1.11
+    iterator end() { return iterator( this, _capacity ); } //!< @version 1.11
+    const_iterator begin() const //!< @version 1.11
+        { return const_iterator( this, _next( 0 )); }
+    const_iterator end() const //!< @version 1.11
+        { return const_iterator( this, _capacity ); }
+
+    /** Swap the content with another map. @version 1.11 */
+    void swap( FlatUUIDHash& rhs );
+
+private:
+    int8_t* _control; // _capacity + group width bytes, see ipp
+    value_type* _slots;
+    size_t _capacity; // 0 or a power of two
+    size_t _size;
+    size_t _growthLeft;
+
+    size_t _find( const uint128_t& key ) const;
+    size_t _findInsertSlot( const uint64_t hash ) const;
+    size_t _next( size_t index ) const;
+    void _setControl( const size_t index, const int8_t value );
+    void _resize( const size_t capacity );
+    void _destroy();
+};
+}
+
+#include "flatUUIDHash.ipp" // template implementation
+
+#endif // LUNCHBOX_FLATUUIDHASH_H
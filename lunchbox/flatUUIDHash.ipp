@@ -0,0 +1,397 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm> // std::swap
+#include <cstring>   // memset
+#include <new>       // placement new
+
+#if defined __SSE2__ || defined _M_X64 || \
+    ( defined _M_IX86_FP && _M_IX86_FP >= 2 )
+#  include <emmintrin.h>
+#  define LB_FLATHASH_SSE2
+#endif
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+namespace detail
+{
+// Control byte values. Used slots store the low seven bits of the hash.
+static const int8_t flatEmpty = -128;
+static const int8_t flatDeleted = -2;
+
+/** A group of control bytes, matched in parallel. */
+class FlatGroup
+{
+public:
+    enum { WIDTH = 16 };
+
+    explicit FlatGroup( const int8_t* control )
+#ifdef LB_FLATHASH_SSE2
+        : _control( _mm_loadu_si128(
+                        reinterpret_cast< const __m128i* >( control )))
+#else
+        : _control( control )
+#endif
+    {}
+
+    /** @return a bitmask of the slots with the given hash bits. */
+    uint32_t match( const int8_t hash ) const
+    {
+#ifdef LB_FLATHASH_SSE2
+        return _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( hash ),
+                                                  _control ));
+#else
+        uint32_t mask = 0;
+        for( uint32_t i = 0; i < WIDTH; ++i )
+            if( _control[i] == hash )
+                mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    /** @return a bitmask of the empty slots. */
+    uint32_t matchEmpty() const { return match( flatEmpty ); }
+
+    /** @return a bitmask of the empty or deleted slots. */
+    uint32_t matchFree() const
+    {
+#ifdef LB_FLATHASH_SSE2
+        return _mm_movemask_epi8( _mm_cmpgt_epi8( _mm_set1_epi8( -1 ),
+                                                  _control ));
+#else
+        uint32_t mask = 0;
+        for( uint32_t i = 0; i < WIDTH; ++i )
+            if( _control[i] < -1 )
+                mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    /** @return the index of the lowest set bit, mask must not be 0. */
+    static uint32_t getLowestBit( const uint32_t mask )
+    {
+#ifdef __GNUC__
+        return __builtin_ctz( mask );
+#else
+        uint32_t index = 0;
+        while( !( mask & ( 1u << index )))
+            ++index;
+        return index;
+#endif
+    }
+
+private:
+#ifdef LB_FLATHASH_SSE2
+    const __m128i _control;
+#else
+    const int8_t* const _control;
+#endif
+};
+
+inline uint64_t flatHash( const uint128_t& key )
+{
+    // The multiplication folds the high word, and the MurmurHash3 finalizer
+    // spreads all input bits to the low bits used for hash2 and the position
+    uint64_t hash = ( key.high() * 0x9E3779B97F4A7C15ull ) ^ key.low();
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline int8_t flatHash2( const uint64_t hash )
+{
+    return static_cast< int8_t >( hash & 0x7f );
+}
+
+inline size_t flatMaxLoad( const size_t capacity )
+{
+    return capacity - capacity / 8;
+}
+
+inline size_t flatCapacity( const size_t size )
+{
+    if( size == 0 )
+        return 0;
+    size_t capacity = FlatGroup::WIDTH;
+    while( flatMaxLoad( capacity ) < size )
+        capacity <<= 1;
+    return capacity;
+}
+}
+/** @endcond */
+
+template< class T > FlatUUIDHash< T >::FlatUUIDHash()
+    : _control( 0 )
+    , _slots( 0 )
+    , _capacity( 0 )
+    , _size( 0 )
+    , _growthLeft( 0 )
+{}
+
+template< class T >
+FlatUUIDHash< T >::FlatUUIDHash( const FlatUUIDHash< T >& from )
+    : _control( 0 )
+    , _slots( 0 )
+    , _capacity( 0 )
+    , _size( 0 )
+    , _growthLeft( 0 )
+{
+    reserve( from._size );
+    for( const_iterator i = from.begin(); i != from.end(); ++i )
+        insert( *i );
+}
+
+template< class T > FlatUUIDHash< T >::~FlatUUIDHash()
+{
+    _destroy();
+}
+
+template< class T >
+FlatUUIDHash< T >& FlatUUIDHash< T >::operator = ( const FlatUUIDHash& from )
+{
+    if( this != &from )
+    {
+        FlatUUIDHash< T > copy( from );
+        swap( copy );
+    }
+    return *this;
+}
+
+template< class T > void FlatUUIDHash< T >::swap( FlatUUIDHash< T >& rhs )
+{
+    std::swap( _control, rhs._control );
+    std::swap( _slots, rhs._slots );
+    std::swap( _capacity, rhs._capacity );
+    std::swap( _size, rhs._size );
+    std::swap( _growthLeft, rhs._growthLeft );
+}
+
+template< class T >
+size_t FlatUUIDHash< T >::_find( const uint128_t& key ) const
+{
+    if( _size == 0 )
+        return _capacity;
+
+    const uint64_t hash = detail::flatHash( key );
+    const int8_t hash2 = detail::flatHash2( hash );
+    const size_t mask = _capacity - 1;
+    size_t pos = ( hash >> 7 ) & mask;
+
+    for( size_t step = detail::FlatGroup::WIDTH; ;
+         step += detail::FlatGroup::WIDTH )
+    {
+        const detail::FlatGroup group( _control + pos );
+        for( uint32_t match = group.match( hash2 ); match;
+             match &= match - 1 )
+        {
+            const size_t index =
+                ( pos + detail::FlatGroup::getLowestBit( match )) & mask;
+            if( LB_LIKELY( _slots[ index ].first == key ))
+                return index;
+        }
+        if( LB_LIKELY( group.matchEmpty( )))
+            return _capacity;
+        pos = ( pos + step ) & mask; // triangular probing visits all groups
+    }
+}
+
+template< class T >
+size_t FlatUUIDHash< T >::_findInsertSlot( const uint64_t hash ) const
+{
+    const size_t mask = _capacity - 1;
+    size_t pos = ( hash >> 7 ) & mask;
+
+    for( size_t step = detail::FlatGroup::WIDTH; ;
+         step += detail::FlatGroup::WIDTH )
+    {
+        const uint32_t match = detail::FlatGroup( _control + pos ).matchFree();
+        if( match )
+            return ( pos + detail::FlatGroup::getLowestBit( match )) & mask;
+        pos = ( pos + step ) & mask;
+    }
+}
+
+template< class T > size_t FlatUUIDHash< T >::_next( size_t index ) const
+{
+    while( index < _capacity && _control[ index ] < 0 )
+        ++index;
+    return index;
+}
+
+template< class T >
+void FlatUUIDHash< T >::_setControl( const size_t index, const int8_t value )
+{
+    _control[ index ] = value;
+    // The first group is mirrored after the end for unaligned group loads
+    if( index < size_t( detail::FlatGroup::WIDTH ))
+        _control[ _capacity + index ] = value;
+}
+
+template< class T > typename FlatUUIDHash< T >::iterator
+FlatUUIDHash< T >::find( const uint128_t& key )
+{
+    return iterator( this, _find( key ));
+}
+
+template< class T > typename FlatUUIDHash< T >::const_iterator
+FlatUUIDHash< T >::find( const uint128_t& key ) const
+{
+    return const_iterator( this, _find( key ));
+}
+
+template< class T >
+std::pair< typename FlatUUIDHash< T >::iterator, bool >
+FlatUUIDHash< T >::insert( const value_type& value )
+{
+    const size_t existing = _find( value.first );
+    if( existing != _capacity )
+        return std::make_pair( iterator( this, existing ), false );
+
+    if( _growthLeft == 0 )
+    {
+        // Reclaim deleted slots if they make up for most of the load
+        if( _size < detail::flatMaxLoad( _capacity ) / 2 )
+            _resize( _capacity );
+        else
+            _resize( LB_MAX( _capacity * 2,
+                             size_t( detail::FlatGroup::WIDTH )));
+    }
+
+    const uint64_t hash = detail::flatHash( value.first );
+    const size_t index = _findInsertSlot( hash );
+    if( _control[ index ] == detail::flatEmpty )
+        --_growthLeft;
+
+    new( &_slots[ index ] ) value_type( value );
+    _setControl( index, detail::flatHash2( hash ));
+    ++_size;
+    return std::make_pair( iterator( this, index ), true );
+}
+
+template< class T > T& FlatUUIDHash< T >::operator[]( const uint128_t& key )
+{
+    const size_t index = _find( key );
+    if( index != _capacity )
+        return _slots[ index ].second;
+    return insert( value_type( key, T( ))).first->second;
+}
+
+template< class T > size_t FlatUUIDHash< T >::erase( const uint128_t& key )
+{
+    const size_t index = _find( key );
+    if( index == _capacity )
+        return 0;
+
+    erase( iterator( this, index ));
+    return 1;
+}
+
+template< class T > void FlatUUIDHash< T >::erase( iterator i )
+{
+    LBASSERT( i._map == this );
+    LBASSERT( i._index < _capacity && _control[ i._index ] >= 0 );
+
+    _slots[ i._index ].~value_type();
+    _setControl( i._index, detail::flatDeleted );
+    --_size;
+}
+
+template< class T > void FlatUUIDHash< T >::clear()
+{
+    for( size_t i = 0; i < _capacity; ++i )
+        if( _control[ i ] >= 0 )
+            _slots[ i ].~value_type();
+
+    if( _capacity )
+        ::memset( _control, detail::flatEmpty,
+                  _capacity + detail::FlatGroup::WIDTH );
+    _size = 0;
+    _growthLeft = detail::flatMaxLoad( _capacity );
+}
+
+template< class T > void FlatUUIDHash< T >::reserve( const size_t size )
+{
+    const size_t capacity = detail::flatCapacity( size );
+    if( capacity > _capacity )
+        _resize( capacity );
+    else if( size > _size + _growthLeft ) // too many deleted slots
+        _resize( _capacity );
+}
+
+template< class T > void FlatUUIDHash< T >::rehash( const size_t size )
+{
+    _resize( detail::flatCapacity( LB_MAX( size, _size )));
+}
+
+template< class T > void FlatUUIDHash< T >::_resize( const size_t capacity )
+{
+    LBASSERT( detail::flatMaxLoad( capacity ) >= _size );
+    int8_t* const oldControl = _control;
+    value_type* const oldSlots = _slots;
+    const size_t oldCapacity = _capacity;
+
+    _capacity = capacity;
+    _growthLeft = detail::flatMaxLoad( capacity ) - _size;
+    if( capacity == 0 )
+    {
+        _control = 0;
+        _slots = 0;
+    }
+    else
+    {
+        _control = new int8_t[ capacity + detail::FlatGroup::WIDTH ];
+        _slots = static_cast< value_type* >(
+            ::operator new( capacity * sizeof( value_type )));
+        ::memset( _control, detail::flatEmpty,
+                  capacity + detail::FlatGroup::WIDTH );
+    }
+
+    for( size_t i = 0; i < oldCapacity; ++i )
+    {
+        if( oldControl[ i ] < 0 )
+            continue;
+
+        const uint64_t hash = detail::flatHash( oldSlots[ i ].first );
+        const size_t index = _findInsertSlot( hash );
+        new( &_slots[ index ] ) value_type( oldSlots[ i ] );
+        _setControl( index, detail::flatHash2( hash ));
+        oldSlots[ i ].~value_type();
+    }
+
+    delete [] oldControl;
+    ::operator delete( oldSlots );
+}
+
+template< class T > void FlatUUIDHash< T >::_destroy()
+{
+    for( size_t i = 0; i < _capacity; ++i )
+        if( _control[ i ] >= 0 )
+            _slots[ i ].~value_type();
+
+    delete [] _control;
+    ::operator delete( _slots );
+    _control = 0;
+    _slots = 0;
+    _capacity = 0;
+    _size = 0;
+    _growthLeft = 0;
+}
+}
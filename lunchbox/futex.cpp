@@ -0,0 +1,94 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "detail/futex.h"
+
+#ifdef __linux__
+#  include <errno.h>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <time.h>
+#  include <unistd.h>
+#else
+#  include "condition.h"
+#  include "scopedMutex.h"
+#endif
+
+namespace lunchbox
+{
+namespace detail
+{
+#ifdef __linux__
+
+bool futexWait( int32_t* word, const int32_t expected, const uint32_t timeout )
+{
+    timespec delta;
+    timespec* deltaPtr = 0;
+    if( timeout != LB_TIMEOUT_INDEFINITE )
+    {
+        delta.tv_sec = timeout / 1000;
+        delta.tv_nsec = ( timeout % 1000 ) * 1000000;
+        deltaPtr = &delta;
+    }
+
+    if( ::syscall( SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, deltaPtr,
+                   0, 0 ) == 0 )
+    {
+        return true;
+    }
+    return errno != ETIMEDOUT; // EAGAIN: value changed, EINTR: spurious
+}
+
+void futexWake( int32_t* word, const int32_t count )
+{
+    ::syscall( SYS_futex, word, FUTEX_WAKE_PRIVATE, count, 0, 0, 0 );
+}
+
+#else
+
+namespace
+{
+// Waiters on a word block on the condition of the word's bucket. Wakeups
+// broadcast the bucket, spurious wakeups of other words are re-checked.
+static const size_t _nBuckets = 64;
+lunchbox::Condition _buckets[ _nBuckets ];
+
+lunchbox::Condition& _getBucket( const int32_t* word )
+{
+    return _buckets[ ( size_t( word ) / sizeof( int32_t )) % _nBuckets ];
+}
+}
+
+bool futexWait( int32_t* word, const int32_t expected, const uint32_t timeout )
+{
+    lunchbox::Condition& bucket = _getBucket( word );
+    ScopedCondition mutex( bucket );
+    if( *const_cast< volatile int32_t* >( word ) != expected )
+        return true;
+    return bucket.timedWait( timeout );
+}
+
+void futexWake( int32_t* word, int32_t )
+{
+    lunchbox::Condition& bucket = _getBucket( word );
+    ScopedCondition mutex( bucket );
+    bucket.broadcast();
+}
+
+#endif
+}
+}
@@ -20,7 +20,10 @@
 
 #include <lunchbox/refPtr.h>      // used inline
 #include <lunchbox/referenced.h>  // base class
+#include <boost/function/function0.hpp>
 #include <boost/noncopyable.hpp> // base class
+#include <boost/optional.hpp>    // member
+#include <boost/utility/result_of.hpp>
 #include <stdexcept>
 
 namespace lunchbox
@@ -32,6 +35,23 @@ public:
     FutureTimeout() : std::runtime_error("") {}
 };
 
+/** Thrown when waiting on a cancelled future. @version 1.11 */
+class FutureCancelled : public std::runtime_error
+{
+public:
+    FutureCancelled() : std::runtime_error( "Future cancelled" ) {}
+};
+
+/**
+ * Thrown when waiting on a future whose promise was destroyed unfulfilled.
+ * @version 1.11
+ */
+class BrokenPromise : public std::runtime_error
+{
+public:
+    BrokenPromise() : std::runtime_error( "Broken promise" ) {}
+};
+
 /** Base class to implement the wait method fulfilling the future. */
 template< class T >
 class FutureImpl : public Referenced, public boost::noncopyable
@@ -54,9 +74,48 @@ public:
      * @return true if the future has been fulfilled, false if it is pending.
      */
     virtual bool isReady() const = 0;
+
+    /** A function called once the future is ready. @version 1.11 */
+    typedef boost::function< void() > Callback;
+
+    /**
+     * Call the given function once the future is ready.
+     *
+     * Implementations fulfilled by another thread call it from that thread,
+     * or immediately if the future is ready. This default implementation
+     * waits for the future in the calling thread.
+     * @version 1.11
+     */
+    virtual void onReady( const Callback& callback )
+    {
+        try
+        {
+            wait();
+        }
+        catch( ... ) {} // rethrown by the next wait()
+        callback();
+    }
+
+    /**
+     * Cancel the operation fulfilling the future if it has not started yet.
+     *
+     * @return true if the future was cancelled. This default implementation
+     *         does not support cancellation and returns false.
+     * @version 1.11
+     */
+    virtual bool cancel() { return false; }
 };
 
-/** A future represents a asynchronous operation. Do not subclass. */
+/**
+ * A future represents a asynchronous operation. Do not subclass.
+ *
+ * Futures created by makeReadyFuture() store their value inline and have no
+ * FutureImpl, which makes them free of heap allocations and reference
+ * counting. Futures fulfilled asynchronously leave this storage empty.
+ *
+ * T has to be copy-constructible, since wait() may be called multiple times
+ * and returns a copy of the value. Move-only types are not supported.
+ */
 template< class T > class Future
 {
 private:
@@ -81,13 +140,25 @@ public:
      */
     T wait( const uint32_t timeout_ = LB_TIMEOUT_INDEFINITE )
     {
+        if( !impl_ )
+            return *value_;
         return impl_->wait( timeout_ );
     }
 
     /**
      * @return true if the future has been fulfilled, false if it is pending.
      */
-    bool isReady() const { return impl_->isReady(); }
+    bool isReady() const { return !impl_ || impl_->isReady(); }
+
+    /**
+     * Cancel the pending operation fulfilling this future.
+     *
+     * Waiting on a cancelled future throws FutureCancelled.
+     * @return true if the operation was cancelled, false if it has started
+     *         already or does not support cancellation.
+     * @version 1.11
+     */
+    bool cancel() { return impl_ && impl_->cancel(); }
 
     /** @name Blocking comparison operators. */
     //@{
@@ -116,8 +187,42 @@ public:
     bool operator >= ( const T& rhs ) { return wait() >= rhs; }
     //@}
 
+    /**
+     * Attach a continuation to this future.
+     *
+     * The function is called with this future once it is ready, from the
+     * thread fulfilling it, or immediately if it is ready already. Its result
+     * or exception fulfills the returned future.
+     *
+     * @param func the continuation, taking a Future< T > parameter.
+     * @return the future result of the continuation.
+     * @version 1.11
+     */
+    template< class F >
+    Future< typename boost::result_of< F( Future< T > ) >::type >
+    then( F func ) const;
+
+    /**
+     * Attach a continuation to this future, run by the given executor.
+     *
+     * @param executor the executor running the continuation.
+     * @param func the continuation, taking a Future< T > parameter.
+     * @return the future result of the continuation.
+     * @version 1.11
+     */
+    template< class F >
+    Future< typename boost::result_of< F( Future< T > ) >::type >
+    then( Executor& executor, F func ) const;
+
 protected:
-    Impl impl_;
+    Impl impl_; //!< 0 for ready futures storing their value inline
+
+private:
+    boost::optional< T > value_; //!< the value of a ready future
+
+    struct Ready {};
+    template< class U > friend Future< U > makeReadyFuture( const U& );
+    Future( const T& value, Ready ) : value_( value ) {}
 };
 
 typedef Future< bool > f_bool_t; //!< A boolean future
@@ -147,16 +252,92 @@ public:
      */
     void wait( const uint32_t timeout_ = LB_TIMEOUT_INDEFINITE )
     {
-        impl_->wait( timeout_ );
+        if( impl_ )
+            impl_->wait( timeout_ );
     }
 
     /**
      * @return true if the future has been fulfilled, false if it is pending.
      */
-    bool isReady() const { return impl_->isReady(); }
+    bool isReady() const { return !impl_ || impl_->isReady(); }
+
+    /**
+     * Cancel the pending operation fulfilling this future.
+     *
+     * Waiting on a cancelled future throws FutureCancelled.
+     * @return true if the operation was cancelled, false if it has started
+     *         already or does not support cancellation.
+     * @version 1.11
+     */
+    bool cancel() { return impl_ && impl_->cancel(); }
+
+    /**
+     * Attach a continuation to this future.
+     *
+     * The function is called with this future once it is ready, from the
+     * thread fulfilling it, or immediately if it is ready already. Its result
+     * or exception fulfills the returned future.
+     *
+     * @param func the continuation, taking a Future< void > parameter.
+     * @return the future result of the continuation.
+     * @version 1.11
+     */
+    template< class F >
+    Future< typename boost::result_of< F( Future< void > ) >::type >
+    then( F func ) const;
+
+    /**
+     * Attach a continuation to this future, run by the given executor.
+     *
+     * @param executor the executor running the continuation.
+     * @param func the continuation, taking a Future< void > parameter.
+     * @return the future result of the continuation.
+     * @version 1.11
+     */
+    template< class F >
+    Future< typename boost::result_of< F( Future< void > ) >::type >
+    then( Executor& executor, F func ) const;
 
 protected:
-    Impl impl_;
+    Impl impl_; //!< 0 for ready futures
+
+private:
+    friend Future< void > makeReadyFuture();
+    Future() {}
 };
+
+/**
+ * @return a ready future holding the given value, without heap allocation.
+ * @version 1.11
+ */
+template< class T > inline Future< T > makeReadyFuture( const T& value )
+{
+    return Future< T >( value, typename Future< T >::Ready( ));
+}
+
+/** @return a ready void future, without heap allocation. @version 1.11 */
+inline Future< void > makeReadyFuture()
+{
+    return Future< void >();
 }
+
+/**
+ * @return a future fulfilled once all futures in the given range are ready.
+ *
+ * The range may contain any futures, including Request objects. Their
+ * results are retrieved by waiting on them.
+ * @version 1.11
+ */
+template< class Iter > Future< void > whenAll( Iter first, Iter last );
+
+/**
+ * @return a future on the index of the first ready future in the given
+ *         range, or the maximum size_t value for an empty range.
+ * @version 1.11
+ */
+template< class Iter > Future< size_t > whenAny( Iter first, Iter last );
+}
+
+#include <lunchbox/promise.h> // includes the template implementation
+
 #endif //LUNCHBOX_FUTURE_H
@@ -0,0 +1,255 @@
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Included by promise.h, which is included by future.h.
+//
+// Continuations are Continuation functors registered using FutureImpl::onReady.
+// They fulfill a Promise with the result of the continued function, either
+// directly or by posting themselves to an Executor.
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/executor.h>
+
+#include <boost/type_traits/is_void.hpp>
+#include <limits>
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+namespace detail
+{
+template< class T, class R, class F > class Continuation
+{
+public:
+    Continuation( const Future< T >& input, const F& func, Executor* executor )
+        : input_( input )
+        , func_( func )
+        , executor_( executor )
+    {}
+
+    Future< R > getFuture() const { return promise_.getFuture(); }
+
+    void operator()()
+    {
+        if( executor_ )
+        {
+            Executor* executor = executor_;
+            executor_ = 0;
+            executor->post( *this );
+            return;
+        }
+        if( promise_.start( )) // not cancelled
+            _run( boost::is_void< R >( ));
+    }
+
+private:
+    Future< T > input_;
+    F func_;
+    Executor* executor_;
+    Promise< R > promise_;
+
+    void _run( boost::false_type )
+    {
+        try
+        {
+            promise_.setValue( func_( input_ ));
+        }
+        catch( ... )
+        {
+            promise_.setException( boost::current_exception( ));
+        }
+    }
+
+    void _run( boost::true_type )
+    {
+        try
+        {
+            func_( input_ );
+            promise_.setValue();
+        }
+        catch( ... )
+        {
+            promise_.setException( boost::current_exception( ));
+        }
+    }
+};
+
+template< class R, class T, class F >
+Future< R > callReady( const Future< T >& input, F& func, boost::false_type )
+{
+    return makeReadyFuture( func( input ));
+}
+
+template< class R, class T, class F >
+Future< R > callReady( const Future< T >& input, F& func, boost::true_type )
+{
+    func( input );
+    return makeReadyFuture();
+}
+
+template< class T, class F >
+Future< typename boost::result_of< F( Future< T > ) >::type >
+then( const Future< T >& input, RefPtr< FutureImpl< T > > impl,
+      const F& func, Executor* executor )
+{
+    typedef typename boost::result_of< F( Future< T > ) >::type R;
+    if( !executor && input.isReady( ))
+    {
+        // only failed continuations of ready futures need a shared state
+        F readyFunc( func );
+        try
+        {
+            return callReady< R >( input, readyFunc, boost::is_void< R >( ));
+        }
+        catch( ... )
+        {
+            Promise< R > failed;
+            failed.setException( boost::current_exception( ));
+            return failed.getFuture();
+        }
+    }
+
+    Continuation< T, R, F > continuation( input, func, executor );
+    const Future< R > output = continuation.getFuture();
+
+    if( input.isReady( ))
+        continuation();
+    else
+        impl->onReady( continuation );
+    return output;
+}
+
+/** Counts the arrivals of whenAll() futures. */
+class WhenAll
+{
+public:
+    typedef void result_type;
+
+    WhenAll() : state_( new State ) {}
+
+    template< class U > void operator()( const U& ) { arrive(); }
+
+    void add() { ++state_->pending; }
+
+    void arrive()
+    {
+        if( --state_->pending == 0 )
+            state_->promise.setValue();
+    }
+
+    Future< void > getFuture() const { return state_->promise.getFuture(); }
+
+private:
+    struct State : public Referenced
+    {
+        State() : pending( 1 ) {} // released by the last arrive()
+
+        a_int32_t pending;
+        Promise< void > promise;
+    };
+
+    RefPtr< State > state_;
+};
+
+/** Fulfills whenAny() with the first arriving index. */
+class WhenAny
+{
+public:
+    typedef void result_type;
+
+    WhenAny() : state_( new State ), index_( 0 ) {}
+
+    template< class U > void operator()( const U& )
+    {
+        if( state_->done.compareAndSwap( 0, 1 ))
+            state_->promise.setValue( index_ );
+    }
+
+    WhenAny at( const size_t index ) const
+    {
+        WhenAny result( *this );
+        result.index_ = index;
+        return result;
+    }
+
+    Future< size_t > getFuture() const { return state_->promise.getFuture(); }
+
+private:
+    struct State : public Referenced
+    {
+        State() : done( 0 ) {}
+
+        a_int32_t done;
+        Promise< size_t > promise;
+    };
+
+    RefPtr< State > state_;
+    size_t index_;
+};
+}
+/** @endcond */
+
+template< class T > template< class F > inline
+Future< typename boost::result_of< F( Future< T > ) >::type >
+Future< T >::then( F func ) const
+{
+    return detail::then( *this, impl_, func, 0 );
+}
+
+template< class T > template< class F > inline
+Future< typename boost::result_of< F( Future< T > ) >::type >
+Future< T >::then( Executor& executor, F func ) const
+{
+    return detail::then( *this, impl_, func, &executor );
+}
+
+template< class F > inline
+Future< typename boost::result_of< F( Future< void > ) >::type >
+Future< void >::then( F func ) const
+{
+    return detail::then( *this, impl_, func, 0 );
+}
+
+template< class F > inline
+Future< typename boost::result_of< F( Future< void > ) >::type >
+Future< void >::then( Executor& executor, F func ) const
+{
+    return detail::then( *this, impl_, func, &executor );
+}
+
+template< class Iter > inline Future< void > whenAll( Iter first, Iter last )
+{
+    detail::WhenAll arrival;
+    for( ; first != last; ++first )
+    {
+        arrival.add();
+        first->then( arrival );
+    }
+    arrival.arrive();
+    return arrival.getFuture();
+}
+
+template< class Iter > inline Future< size_t > whenAny( Iter first, Iter last )
+{
+    if( first == last )
+        return makeReadyFuture( std::numeric_limits< size_t >::max( ));
+
+    const detail::WhenAny arrival;
+    for( size_t i = 0; first != last; ++first, ++i )
+        first->then( arrival.at( i ));
+    return arrival.getFuture();
+}
+}
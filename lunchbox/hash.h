@@ -70,7 +70,7 @@ template< class K, class T > class RefPtrHash
 #endif
 
 #ifdef LUNCHBOX_USE_V1_API
-/** A hash for UUID keys. @version 1.0 */
+/** A hash for UUID keys. @sa FlatUUIDHash @version 1.0 */
 template<class T> class UUIDHash : public stde::hash_map<lunchbox::UUID, T> {};
 #endif
 
@@ -0,0 +1,97 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "latch.h"
+
+#include "debug.h"
+#include "detail/futex.h"
+
+#include <limits>
+
+namespace lunchbox
+{
+namespace
+{
+typedef Atomic< int32_t > Ops;
+}
+
+Latch::Latch( const size_t count )
+    : _count( int32_t( count ))
+    , _nWaiters( 0 )
+{
+    LBASSERT( count <= size_t( std::numeric_limits< int32_t >::max( )));
+}
+
+Latch::~Latch()
+{
+    LBASSERTINFO( _nWaiters == 0, _nWaiters << " threads waiting" );
+}
+
+void Latch::countDown( const size_t n )
+{
+    const int32_t count = Ops::getAndSub( _count, int32_t( n ));
+    LBASSERTINFO( count >= int32_t( n ), "Latch counted down below zero" );
+
+    // The atomic update orders the count before reading the waiters, which
+    // count themselves before reading the count.
+    if( count == int32_t( n ) && detail::load( _nWaiters ) > 0 )
+        detail::futexWake( &_count, std::numeric_limits< int32_t >::max( ));
+}
+
+void Latch::arriveAndWait()
+{
+    countDown();
+    wait();
+}
+
+bool Latch::wait( const uint32_t timeout ) const
+{
+    if( isOpen( ))
+        return true;
+
+    const detail::Deadline deadline( timeout );
+    Ops::incAndGet( _nWaiters );
+    bool open = true;
+    while( true )
+    {
+        const int32_t count = detail::load( _count );
+        if( count == 0 )
+            break;
+
+        const uint32_t remaining = deadline.getRemaining();
+        if( remaining == 0 ||
+            !detail::futexWait( &_count, count, remaining ))
+        {
+            open = isOpen();
+            break;
+        }
+    }
+    Ops::decAndGet( _nWaiters );
+    return open;
+}
+
+bool Latch::isOpen() const
+{
+    return getCount() == 0;
+}
+
+size_t Latch::getCount() const
+{
+    return size_t( detail::load( _count ));
+}
+
+}
@@ -0,0 +1,76 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_LATCH_H
+#define LUNCHBOX_LATCH_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * A single-use countdown latch.
+ *
+ * Threads waiting on the latch are blocked until it has been counted down to
+ * zero. Counting down and testing the latch are lock-free, only threads which
+ * have to wait block in the kernel, and only the final count down wakes them.
+ *
+ * Example: @include tests/latch.cpp
+ */
+class Latch : public boost::noncopyable
+{
+public:
+    /** Construct a new latch with the given count. @version 1.11 */
+    LUNCHBOX_API explicit Latch( size_t count );
+
+    /** Destruct the latch. No thread may wait on it. @version 1.11 */
+    LUNCHBOX_API ~Latch();
+
+    /**
+     * Decrement the count, releasing all waiters when it reaches zero.
+     * @version 1.11
+     */
+    LUNCHBOX_API void countDown( size_t n = 1 );
+
+    /** Count down by one and wait for the latch to open. @version 1.11 */
+    LUNCHBOX_API void arriveAndWait();
+
+    /**
+     * Wait for the count to reach zero.
+     *
+     * @param timeout the timeout in milliseconds.
+     * @return true if the latch is open, false on timeout.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool wait( uint32_t timeout = LB_TIMEOUT_INDEFINITE ) const;
+
+    /** @return true if the count has reached zero. @version 1.11 */
+    LUNCHBOX_API bool isOpen() const;
+
+    /** @return the current count. @version 1.11 */
+    LUNCHBOX_API size_t getCount() const;
+
+private:
+    mutable int32_t _count;
+    mutable int32_t _nWaiters;
+};
+}
+
+#endif // LUNCHBOX_LATCH_H
@@ -0,0 +1,85 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_LFPOOL_H
+#define LUNCHBOX_LFPOOL_H
+
+#include <lunchbox/atomic.h> // used inline
+#include <lunchbox/debug.h>  // used inline
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * A lock-free object allocation pool.
+ *
+ * Provides the same interface as Pool< T, true >, but alloc() and release()
+ * never block. Cached items are kept on a lock-free stack. Each stack entry is
+ * a node in a table which only grows, and the stack head holds the node index
+ * together with a tag incremented on each modification, which avoids the ABA
+ * problem of a naive compare-and-swap stack.
+ *
+ * The pool caches at most MAX_SIZE items, further released items are deleted.
+ *
+ * Example: @include tests/lfPool.cpp
+ */
+template< class T > class LFPool : public boost::noncopyable
+{
+public:
+    enum { MAX_SIZE = 1 << 20 }; //!< The maximum number of cached items
+
+    /** Construct a new pool. @version 1.11 */
+    LFPool();
+
+    /** Destruct this pool and all cached items. @version 1.11 */
+    ~LFPool();
+
+    /** @return a reusable or new item. @version 1.11 */
+    T* alloc();
+
+    /** Release an item for reuse. @version 1.11 */
+    void release( T* item );
+
+    /** Delete all cached items. @version 1.11 */
+    void flush();
+
+private:
+    enum
+    {
+        CHUNK_BITS = 10,
+        CHUNK_SIZE = 1 << CHUNK_BITS,
+        NCHUNKS = MAX_SIZE / CHUNK_SIZE
+    };
+
+    struct Node;
+
+    Node* _chunks[ NCHUNKS ];
+    a_int32_t _end;  // number of nodes handed out
+    int64_t _items;  // head of the stack of nodes holding a cached item
+    int64_t _nodes;  // head of the stack of unused nodes
+
+    Node& _getNode( const int32_t index );
+    int32_t _allocate();
+    int32_t _pop( int64_t& head );
+    void _push( int64_t& head, const int32_t index );
+};
+}
+
+#include "lfPool.ipp" // template implementation
+
+#endif // LUNCHBOX_LFPOOL_H
@@ -0,0 +1,155 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// A stack head stores the tag in the upper 32 bits and the index of the top
+// node plus one in the lower 32 bits, i.e., 0 is an empty stack. Nodes are
+// never freed before the pool is destroyed, so reading the next index of a
+// node popped concurrently is safe; the tag makes the following CAS fail.
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+template< class T > struct LFPool< T >::Node
+{
+    Node() : item( 0 ), next( 0 ) {}
+
+    T* item;
+    int32_t next; // index of the next node plus one, 0 for none
+};
+/** @endcond */
+
+template< class T > LFPool< T >::LFPool()
+    : _end( 0 )
+    , _items( 0 )
+    , _nodes( 0 )
+{
+    for( size_t i = 0; i < NCHUNKS; ++i )
+        _chunks[ i ] = 0;
+}
+
+template< class T > LFPool< T >::~LFPool()
+{
+    flush();
+    for( size_t i = 0; i < NCHUNKS; ++i )
+        delete [] _chunks[ i ];
+}
+
+template< class T > T* LFPool< T >::alloc()
+{
+    const int32_t index = _pop( _items );
+    if( index < 0 )
+        return new T;
+
+    T* item = _getNode( index ).item;
+    _push( _nodes, index );
+    return item;
+}
+
+template< class T > void LFPool< T >::release( T* item )
+{
+    int32_t index = _pop( _nodes );
+    if( index < 0 )
+    {
+        index = _allocate();
+        if( index < 0 ) // pool is full
+        {
+            delete item;
+            return;
+        }
+    }
+
+    _getNode( index ).item = item;
+    _push( _items, index );
+}
+
+template< class T > void LFPool< T >::flush()
+{
+    for( int32_t index = _pop( _items ); index >= 0; index = _pop( _items ))
+    {
+        delete _getNode( index ).item;
+        _push( _nodes, index );
+    }
+}
+
+template< class T >
+typename LFPool< T >::Node& LFPool< T >::_getNode( const int32_t index )
+{
+    Node* const chunk = *static_cast< Node* volatile* >(
+        &_chunks[ index >> CHUNK_BITS ] );
+    LBASSERT( chunk );
+    return chunk[ index & ( CHUNK_SIZE - 1 ) ];
+}
+
+template< class T > int32_t LFPool< T >::_allocate()
+{
+    int32_t end;
+    do
+    {
+        end = _end;
+        if( end >= int32_t( MAX_SIZE ))
+            return -1;
+    }
+    while( !_end.compareAndSwap( end, end + 1 ));
+
+    Node*& chunk = _chunks[ end >> CHUNK_BITS ];
+    if( !*static_cast< Node* volatile* >( &chunk ))
+    {
+        Node* const newChunk = new Node[ CHUNK_SIZE ];
+        if( !Atomic< Node* >::compareAndSwap( &chunk, 0, newChunk ))
+            delete [] newChunk;
+    }
+    return end;
+}
+
+template< class T > int32_t LFPool< T >::_pop( int64_t& head )
+{
+    for( ;; )
+    {
+        const int64_t old = *static_cast< volatile int64_t* >( &head );
+        const int32_t top = int32_t( old & 0xffffffff );
+        if( top == 0 )
+            return -1;
+
+        const int32_t next = *static_cast< volatile int32_t* >(
+            &_getNode( top - 1 ).next );
+        const uint64_t tag = ( uint64_t( old ) >> 32 ) + 1;
+        if( Atomic< int64_t >::compareAndSwap( &head, old,
+                                               int64_t(( tag << 32 ) | next )))
+        {
+            return top - 1;
+        }
+    }
+}
+
+template< class T >
+void LFPool< T >::_push( int64_t& head, const int32_t index )
+{
+    Node& node = _getNode( index );
+    for( ;; )
+    {
+        const int64_t old = *static_cast< volatile int64_t* >( &head );
+        node.next = int32_t( old & 0xffffffff );
+        const uint64_t tag = ( uint64_t( old ) >> 32 ) + 1;
+        const uint64_t top = uint64_t( index + 1 );
+        if( Atomic< int64_t >::compareAndSwap( &head, old,
+                                               int64_t(( tag << 32 ) | top )))
+        {
+            return;
+        }
+    }
+}
+}
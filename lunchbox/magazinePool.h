@@ -0,0 +1,127 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_MAGAZINEPOOL_H
+#define LUNCHBOX_MAGAZINEPOOL_H
+
+#include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinLock.h>    // member
+#include <lunchbox/tls.h>         // member
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace lunchbox
+{
+/**
+ * A thread-safe object allocation pool with per-thread caches.
+ *
+ * Each thread caches released items in two magazines of a fixed size. Items
+ * are allocated from and released to the magazines of the calling thread
+ * without locking. Only when both magazines are empty on alloc(), or full on
+ * release(), a magazine is exchanged with a shared depot, which is protected
+ * by a SpinLock. The depot holds a bounded number of full magazines; items
+ * released beyond that are deleted.
+ *
+ * The cache of a thread is returned to the depot when the thread exits. Items
+ * may be released by a different thread than the one which allocated them.
+ *
+ * Compared to Pool< T, true >, the shared lock is taken once per magazine
+ * instead of once per operation.
+ *
+ * Example: @include tests/magazinePool.cpp
+ */
+template< class T > class MagazinePool : public boost::noncopyable
+{
+public:
+    /** Pool usage statistics. @version 1.11 */
+    struct Stats
+    {
+        Stats() : nCreated( 0 ), nDeleted( 0 ), nLoads( 0 ), nStores( 0 )
+                , nCached( 0 ), nThreads( 0 ) {}
+
+        size_t nCreated; //!< Items allocated since they were not cached
+        size_t nDeleted; //!< Items deleted since the depot was full
+        size_t nLoads;   //!< Full magazines taken from the depot
+        size_t nStores;  //!< Full magazines returned to the depot
+        size_t nCached;  //!< Items currently in the depot
+        size_t nThreads; //!< Threads currently holding a cache
+    };
+
+    /**
+     * Construct a new pool.
+     *
+     * @param magazineSize the number of items per magazine.
+     * @param maxMagazines the maximum number of full magazines in the depot.
+     * @version 1.11
+     */
+    explicit MagazinePool( size_t magazineSize = 32, size_t maxMagazines = 64 );
+
+    /**
+     * Destruct this pool and all cached items.
+     *
+     * No thread may use the pool during or after destruction.
+     * @version 1.11
+     */
+    ~MagazinePool();
+
+    /** @return a reusable or new item. @version 1.11 */
+    T* alloc();
+
+    /** Release an item for reuse. @version 1.11 */
+    void release( T* item );
+
+    /**
+     * Delete all items cached in the depot and by the calling thread.
+     *
+     * Items cached by other threads are not affected.
+     * @version 1.11
+     */
+    void flush();
+
+    /** @return the current usage statistics. @version 1.11 */
+    Stats getStats() const;
+
+    /** @return the number of items per magazine. @version 1.11 */
+    size_t getMagazineSize() const { return _magazineSize; }
+
+private:
+    typedef std::vector< T* > Magazine;
+    struct Cache;
+
+    const size_t _magazineSize;
+    const size_t _maxMagazines;
+    TLS _caches; // Cache of the calling thread
+
+    mutable SpinLock _lock; // protects all members below
+    std::vector< Magazine* > _full;
+    std::vector< Magazine* > _empty;
+    std::vector< Cache* > _threads;
+    Stats _stats;
+
+    Cache* _getCache();
+    bool _load( Cache* cache );
+    void _store( Cache* cache );
+    Magazine* _newMagazine();
+    void _deleteItems( Magazine* magazine );
+    static void _exitThread( void* cache );
+};
+}
+
+#include "magazinePool.ipp" // template implementation
+
+#endif // LUNCHBOX_MAGAZINEPOOL_H
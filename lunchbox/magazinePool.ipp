@@ -0,0 +1,253 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm> // std::swap, std::find
+
+// The thread caches follow Bonwick & Adams, "Magazines and Vmem", USENIX 2001.
+// A thread allocates from its loaded magazine, and swaps it with the previous
+// magazine if that one is full (on alloc) or empty (on release). Only if the
+// swap does not help, a magazine is exchanged with the depot.
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+template< class T > struct MagazinePool< T >::Cache
+{
+    explicit Cache( MagazinePool* owner )
+        : pool( owner )
+        , loaded( owner->_newMagazine( ))
+        , previous( owner->_newMagazine( ))
+    {}
+
+    ~Cache()
+    {
+        delete loaded;
+        delete previous;
+    }
+
+    MagazinePool* const pool;
+    Magazine* loaded;
+    Magazine* previous;
+};
+/** @endcond */
+
+template< class T >
+MagazinePool< T >::MagazinePool( const size_t magazineSize,
+                                 const size_t maxMagazines )
+    : _magazineSize( magazineSize )
+    , _maxMagazines( maxMagazines )
+    , _caches( &MagazinePool< T >::_exitThread )
+{
+    LBASSERT( magazineSize > 0 );
+}
+
+template< class T > MagazinePool< T >::~MagazinePool()
+{
+    _caches.set( 0 ); // deleted below, ~TLS would return it to the depot
+    for( size_t i = 0; i < _threads.size(); ++i )
+    {
+        _deleteItems( _threads[i]->loaded );
+        _deleteItems( _threads[i]->previous );
+        delete _threads[i];
+    }
+    for( size_t i = 0; i < _full.size(); ++i )
+    {
+        _deleteItems( _full[i] );
+        delete _full[i];
+    }
+    for( size_t i = 0; i < _empty.size(); ++i )
+        delete _empty[i];
+}
+
+template< class T > T* MagazinePool< T >::alloc()
+{
+    Cache* cache = _getCache();
+    if( cache->loaded->empty( ))
+    {
+        if( !cache->previous->empty( ))
+            std::swap( cache->loaded, cache->previous );
+        else if( !_load( cache ))
+            return new T;
+    }
+
+    T* item = cache->loaded->back();
+    cache->loaded->pop_back();
+    return item;
+}
+
+template< class T > void MagazinePool< T >::release( T* item )
+{
+    Cache* cache = _getCache();
+    if( cache->loaded->size() >= _magazineSize )
+    {
+        if( cache->previous->empty( ))
+            std::swap( cache->loaded, cache->previous );
+        else
+            _store( cache );
+    }
+    cache->loaded->push_back( item );
+}
+
+template< class T > void MagazinePool< T >::flush()
+{
+    std::vector< Magazine* > full;
+    {
+        ScopedFastWrite mutex( _lock );
+        full.swap( _full );
+        _stats.nCached = 0;
+    }
+
+    for( size_t i = 0; i < full.size(); ++i )
+    {
+        _deleteItems( full[i] );
+        delete full[i];
+    }
+
+    Cache* cache = static_cast< Cache* >( _caches.get( ));
+    if( cache )
+    {
+        _deleteItems( cache->loaded );
+        _deleteItems( cache->previous );
+    }
+}
+
+template< class T >
+typename MagazinePool< T >::Stats MagazinePool< T >::getStats() const
+{
+    ScopedFastWrite mutex( _lock );
+    return _stats;
+}
+
+template< class T >
+typename MagazinePool< T >::Cache* MagazinePool< T >::_getCache()
+{
+    Cache* cache = static_cast< Cache* >( _caches.get( ));
+    if( LB_LIKELY( cache != 0 ))
+        return cache;
+
+    cache = new Cache( this );
+    _caches.set( cache );
+
+    ScopedFastWrite mutex( _lock );
+    _threads.push_back( cache );
+    ++_stats.nThreads;
+    return cache;
+}
+
+template< class T > bool MagazinePool< T >::_load( Cache* cache )
+{
+    ScopedFastWrite mutex( _lock );
+    if( _full.empty( ))
+    {
+        ++_stats.nCreated;
+        return false;
+    }
+
+    _empty.push_back( cache->loaded );
+    cache->loaded = _full.back();
+    _full.pop_back();
+    ++_stats.nLoads;
+    _stats.nCached -= cache->loaded->size();
+    return true;
+}
+
+template< class T > void MagazinePool< T >::_store( Cache* cache )
+{
+    Magazine* full = cache->loaded;
+    {
+        ScopedFastWrite mutex( _lock );
+        if( _full.size() >= _maxMagazines )
+            _stats.nDeleted += full->size();
+        else
+        {
+            _full.push_back( full );
+            ++_stats.nStores;
+            _stats.nCached += full->size();
+            if( !_empty.empty( ))
+            {
+                cache->loaded = _empty.back();
+                _empty.pop_back();
+                return;
+            }
+            full = 0;
+        }
+    }
+
+    if( full ) // depot is full, reuse emptied magazine
+        _deleteItems( full );
+    else
+        cache->loaded = _newMagazine();
+}
+
+template< class T >
+typename MagazinePool< T >::Magazine* MagazinePool< T >::_newMagazine()
+{
+    Magazine* magazine = new Magazine;
+    magazine->reserve( _magazineSize );
+    return magazine;
+}
+
+template< class T > void MagazinePool< T >::_deleteItems( Magazine* magazine )
+{
+    for( size_t i = 0; i < magazine->size(); ++i )
+        delete (*magazine)[i];
+    magazine->clear();
+}
+
+template< class T > void MagazinePool< T >::_exitThread( void* data )
+{
+    Cache* cache = static_cast< Cache* >( data );
+    MagazinePool< T >* pool = cache->pool;
+    Magazine* magazines[] = { cache->loaded, cache->previous };
+    cache->loaded = cache->previous = 0;
+    {
+        ScopedFastWrite mutex( pool->_lock );
+        pool->_threads.erase( std::find( pool->_threads.begin(),
+                                         pool->_threads.end(), cache ));
+        --pool->_stats.nThreads;
+
+        for( size_t i = 0; i < 2; ++i )
+        {
+            Magazine* magazine = magazines[i];
+            if( magazine->empty( ))
+                pool->_empty.push_back( magazine );
+            else if( pool->_full.size() < pool->_maxMagazines )
+            {
+                // partially filled magazines are fine for loading
+                pool->_full.push_back( magazine );
+                ++pool->_stats.nStores;
+                pool->_stats.nCached += magazine->size();
+            }
+            else
+            {
+                pool->_stats.nDeleted += magazine->size();
+                continue;
+            }
+            magazines[i] = 0;
+        }
+    }
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        if( !magazines[i] )
+            continue;
+        pool->_deleteItems( magazines[i] );
+        delete magazines[i];
+    }
+    delete cache;
+}
+}
@@ -19,8 +19,11 @@
 #ifndef LUNCHBOX_MONITOR_H
 #define LUNCHBOX_MONITOR_H
 
+#include <lunchbox/atomic.h>      // member
 #include <lunchbox/condition.h>   // member
+#include <lunchbox/lock.h>        // member
 #include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinWait.h>    // used inline
 #include <lunchbox/types.h>
 
 #include <errno.h>
@@ -29,6 +32,9 @@
 #include <typeinfo>
 #include <functional>
 #include <boost/bind.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
 
 namespace lunchbox
 {
@@ -39,6 +45,10 @@ namespace lunchbox
  * caller is blocked until the condition is fulfilled. The concept is similar to
  * a pthread condition, with more usage convenience.
  *
+ * Changing the value only wakes up the waiting threads whose condition is
+ * fulfilled by the new value. Integral values of 32 or 64 bit are changed
+ * using atomic operations without locking if no thread is waiting.
+ *
  * Example: @include tests/monitor.cpp
  */
 template< class T > class Monitor
@@ -48,13 +58,14 @@ template< class T > class Monitor
 
 public:
     /** Construct a new monitor with a default value of 0. @version 1.0 */
-    Monitor() : _value( T( 0 )) {}
+    Monitor() : _value( T( 0 )), _waiters( 0 ) {}
 
     /** Construct a new monitor with a given default value. @version 1.0 */
-    explicit Monitor( const T& value ) : _value( value ) {}
+    explicit Monitor( const T& value ) : _value( value ), _waiters( 0 ) {}
 
     /** Ctor initializing with the given monitor value. @version 1.1.5 */
-    Monitor( const Monitor< T >& from ) : _value( from._value ) {}
+    Monitor( const Monitor< T >& from )
+        : _value( from._value ), _waiters( 0 ) {}
 
     /** Destructs the monitor. @version 1.0 */
     ~Monitor() {}
@@ -64,18 +75,14 @@ public:
     /** Increment the monitored value, prefix only. @version 1.0 */
     Monitor& operator++ ()
         {
-            ScopedCondition mutex( _cond );
-            ++_value;
-            _cond.broadcast();
+            _update( &Monitor< T >::_increment, _value );
             return *this;
         }
 
     /** Decrement the monitored value, prefix only. @version 1.0 */
     Monitor& operator-- ()
         {
-            ScopedCondition mutex( _cond );
-            --_value;
-            _cond.broadcast();
+            _update( &Monitor< T >::_decrement, _value );
             return *this;
         }
 
@@ -96,28 +103,19 @@ public:
     /** Perform an or operation on the value. @version 1.0 */
     Monitor& operator |= ( const T& value )
         {
-            ScopedCondition mutex( _cond );
-            _value |= value;
-            _cond.broadcast();
+            _update( &Monitor< T >::_or, value );
             return *this;
         }
 
     /** Perform an and operation on the value. @version 1.7 */
     Monitor& operator &= ( const T& value )
         {
-            ScopedCondition mutex( _cond );
-            _value &= value;
-            _cond.broadcast();
+            _update( &Monitor< T >::_and, value );
             return *this;
         }
 
     /** Set a new value. @version 1.0 */
-    void set( const T& value )
-        {
-            ScopedCondition mutex( _cond );
-            _value = value;
-            _cond.broadcast();
-        }
+    void set( const T& value ) { _update( &Monitor< T >::_assign, value ); }
     //@}
 
     /** @name Monitor the value. */
@@ -151,16 +149,8 @@ public:
      */
     const T waitNE( const T& v1, const T& v2 ) const
         {
-            if( sizeof( T ) <= 8 ) // issue #1
-            {
-                const T current = _value;
-                if( current != v1 && current != v2 )
-                    return current;
-            }
-            ScopedCondition mutex( _cond );
-            while( _value == v1 || _value == v2 )
-                _cond.wait();
-            return _value;
+            return _waitPredicate(
+                boost::bind( &Monitor< T >::_isNeither, _1, v1, v2 ));
         }
 
     /**
@@ -291,69 +281,69 @@ public:
     //@{
     bool operator == ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value == value;
         }
     bool operator != ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value != value;
         }
     bool operator < ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value < value;
         }
     bool operator > ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value > value;
         }
     bool operator <= ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value <= value;
         }
     bool operator >= ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value >= value;
         }
 
     bool operator == ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value == rhs._value;
         }
     bool operator != ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value != rhs._value;
         }
     bool operator < ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value < rhs._value;
         }
     bool operator > ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value > rhs._value;
         }
     bool operator <= ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value <= rhs._value;
         }
     bool operator >= ( const Monitor<T>& rhs ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value >= rhs._value;
         }
     /** @return a bool conversion of the result. @version 1.9.1 */
     operator bool_t()
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value ? &Monitor< T >::bool_true : 0;
         }
     //@}
@@ -369,61 +359,247 @@ public:
     /** @return the current plus the given value. @version 1.0 */
     T operator + ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return _value + value;
         }
 
     /** @return the current or'ed with the given value. @version 1.0 */
     T operator | ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return static_cast< T >( _value | value );
         }
 
     /** @return the current and the given value. @version 1.0 */
     T operator & ( const T& value ) const
         {
-            ScopedCondition mutex( sizeof(T)>8 ? &_cond : 0 ); // issue #1
+            ScopedWrite mutex( sizeof(T)>8 ? &_lock : 0 ); // issue #1
             return static_cast< T >( _value & value );
         }
     //@}
 
 private:
+    /** A thread blocked until the value fulfills its predicate. */
+    class Waiter : public boost::noncopyable
+    {
+    public:
+        template< typename F >
+        Waiter( const F& predicate_, a_int32_t& nWaiters )
+            : check( &Monitor< T >::_check< F > )
+            , predicate( &predicate_ )
+            , woken( false )
+            , previous( 0 )
+            , next( 0 )
+            , _nWaiters( nWaiters )
+        {
+            ++_nWaiters;
+        }
+
+        ~Waiter() { --_nWaiters; }
+
+        bool (* const check )( const void*, const T& );
+        const void* const predicate;
+        Condition condition;
+        T value; // the value fulfilling the predicate, set on wakeup
+        bool woken;
+        Waiter* previous;
+        Waiter* next;
+
+    private:
+        a_int32_t& _nWaiters;
+    };
+
     T _value;
-    mutable Condition _cond;
+    mutable Lock _lock; // protects _waiters and non-atomic updates
+    mutable a_int32_t _nWaiters; // number of threads blocked in a wait
+    mutable Waiter* _waiters;
+
+    // Integral types with native atomics are updated without locking
+#ifdef LB_GCC_4_1_OR_LATER
+    enum { _lockFree = boost::is_integral< T >::value &&
+                       ( sizeof( T ) == 4 || sizeof( T ) == 8 ) };
+#else
+    enum { _lockFree = false };
+#endif
+
+    typedef void (*Operation)( T&, const T& );
+
+    static void _increment( T& value, const T& ) { ++value; }
+    static void _decrement( T& value, const T& ) { --value; }
+    static void _assign( T& value, const T& arg ) { value = arg; }
+    static void _or( T& value, const T& arg ) { value |= arg; }
+    static void _and( T& value, const T& arg ) { value &= arg; }
+
+    static bool _isNeither( const T& value, const T& v1, const T& v2 )
+        { return value != v1 && value != v2; }
 
     template< typename F >
-    const T _waitPredicate( const F& predicate ) const
+    static bool _check( const void* predicate, const T& value )
+        { return (*static_cast< const F* >( predicate ))( value ); }
+
+    void _update( const Operation operation, const T& arg )
+        {
+            _update( operation, arg,
+                     boost::integral_constant< bool, _lockFree >( ));
+        }
+
+    void _update( const Operation operation, const T& arg,
+                  const boost::true_type& )
+        {
+            const T copy = arg; // arg may alias _value
+            T oldValue;
+            T newValue;
+            do
+            {
+                oldValue = _value;
+                newValue = oldValue;
+                operation( newValue, copy );
+            }
+            while( !Atomic< T >::compareAndSwap( &_value, oldValue, newValue ));
+
+            // The full barrier of the CAS orders the update before the waiter
+            // count read, and waiters count themselves before testing the
+            // value. Either the update is seen, or the waiter is woken up.
+            if( _nWaiters > 0 )
+            {
+                ScopedWrite mutex( _lock );
+                _notify();
+            }
+        }
+
+    void _update( const Operation operation, const T& arg,
+                  const boost::false_type& )
+        {
+            ScopedWrite mutex( _lock );
+            operation( _value, arg );
+            _notify();
+        }
+
+    // Wake up the waiters fulfilled by the current value, needs to hold _lock
+    void _notify()
+        {
+            Waiter* waiter = _waiters;
+            while( waiter )
+            {
+                Waiter* const next = waiter->next;
+                if( waiter->check( waiter->predicate, _value ))
+                {
+                    _unregister( *waiter );
+                    ScopedCondition mutex( waiter->condition );
+                    waiter->value = _value;
+                    waiter->woken = true;
+                    waiter->condition.signal();
+                }
+                waiter = next;
+            }
+        }
+
+    void _register( Waiter& waiter ) const
+        {
+            waiter.next = _waiters;
+            if( _waiters )
+                _waiters->previous = &waiter;
+            _waiters = &waiter;
+        }
+
+    void _unregister( Waiter& waiter ) const
+        {
+            if( waiter.previous )
+                waiter.previous->next = waiter.next;
+            else
+                _waiters = waiter.next;
+            if( waiter.next )
+                waiter.next->previous = waiter.previous;
+        }
+
+    // Poll the value for a short time before blocking. Timed waits only
+    // busy-wait, since yielding may exceed short timeouts.
+    template< typename F >
+    bool _spin( const F& predicate, const uint32_t timeout, T& value ) const
         {
-            if( sizeof( T ) <= 8 ) // issue #1
+            if( sizeof( T ) > 8 ) // issue #1
+                return false;
+            if( timeout == 0 ) // _wait() checks the predicate once
+                return false;
+
+            SpinWait spin;
+            while( true )
             {
+                memoryBarrierAcquire();
                 const T current = _value;
                 if( predicate( current ))
-                    return current;
+                {
+                    value = current;
+                    return true;
+                }
+                if( timeout == LB_TIMEOUT_INDEFINITE ? spin.shouldPark()
+                                                     : spin.willYield( ))
+                {
+                    return false;
+                }
+                spin.spinOnce();
             }
-            ScopedCondition mutex( _cond );
-            while( !predicate( _value ))
-                _cond.wait();
-            return _value;
+        }
+
+    template< typename F >
+    const T _waitPredicate( const F& predicate ) const
+        {
+            T value = T();
+            if( _spin( predicate, LB_TIMEOUT_INDEFINITE, value ))
+                return value;
+            _wait( predicate, LB_TIMEOUT_INDEFINITE, value );
+            return value;
         }
 
     template< typename F >
     bool _timedWaitPredicate( const F& predicate, const uint32_t timeout ) const
         {
-            if( sizeof( T ) <= 8 ) // issue #1
+            T value = T();
+            if( _spin( predicate, timeout, value ))
+                return true;
+            return _wait( predicate, timeout, value );
+        }
+
+    /**
+     * Block on a private condition until an update fulfills the predicate.
+     * Only the waiters fulfilled by a new value are woken up.
+     */
+    template< typename F >
+    bool _wait( const F& predicate, const uint32_t timeout, T& value ) const
+        {
+            Waiter waiter( predicate, _nWaiters );
             {
-                const T current = _value;
-                if( predicate( current ))
+                ScopedWrite mutex( _lock );
+                if( predicate( _value ))
+                {
+                    value = _value;
                     return true;
+                }
+                _register( waiter );
+                waiter.condition.lock(); // before _lock is released
             }
-            ScopedCondition mutex( _cond );
-            while( !predicate( _value ))
+
+            bool woken = true;
+            while( !waiter.woken )
+            {
+                if( !waiter.condition.timedWait( timeout ))
+                {
+                    woken = waiter.woken;
+                    break;
+                }
+            }
+            waiter.condition.unlock();
+
+            if( !woken )
             {
-                if( !_cond.timedWait( timeout ) )
+                ScopedWrite mutex( _lock );
+                if( !waiter.woken ) // not woken up after timeout
                 {
+                    _unregister( waiter );
                     return false;
                 }
             }
+            value = waiter.value;
             return true;
         }
 };
@@ -442,19 +618,19 @@ inline std::ostream& operator << ( std::ostream& os,
 
 template<> inline Monitor< bool >& Monitor< bool >::operator++ ()
 {
-    ScopedCondition mutex( _cond );
+    ScopedWrite mutex( _lock );
     assert( !_value );
     _value = !_value;
-    _cond.broadcast();
+    _notify();
     return *this;
 }
 
 template<> inline Monitor< bool >& Monitor< bool >::operator-- ()
 {
-    ScopedCondition mutex( _cond );
+    ScopedWrite mutex( _lock );
     assert( !_value );
     _value = !_value;
-    _cond.broadcast();
+    _notify();
     return *this;
 }
 
@@ -463,9 +639,9 @@ Monitor< bool >& Monitor< bool >::operator |= ( const bool& value )
 {
     if( value )
     {
-        ScopedCondition mutex( _cond );
+        ScopedWrite mutex( _lock );
         _value = value;
-        _cond.broadcast();
+        _notify();
     }
     return *this;
 }
@@ -474,7 +650,7 @@ Monitor< bool >& Monitor< bool >::operator |= ( const bool& value )
 #include <lunchbox/uint128_t.h>
 namespace lunchbox
 {
-template<> inline Monitor< uint128_t >::Monitor() {}
+template<> inline Monitor< uint128_t >::Monitor() : _waiters( 0 ) {}
 }
 
 #endif //LUNCHBOX_MONITOR_H
@@ -19,8 +19,10 @@
 #ifndef LUNCHBOX_MTQUEUE_H
 #define LUNCHBOX_MTQUEUE_H
 
+#include <lunchbox/atomic.h>    // used inline
 #include <lunchbox/condition.h>
 #include <lunchbox/debug.h>
+#include <lunchbox/spinWait.h> // used inline
 
 #include <algorithm>
 #include <limits.h>
@@ -49,10 +51,11 @@ public:
     typedef T value_type;
 
     /** Construct a new queue. @version 1.0 */
-    explicit MTQueue( const size_t maxSize = S ) : _maxSize( maxSize ) {}
+    explicit MTQueue( const size_t maxSize = S )
+        : _size( 0 ), _maxSize( maxSize ) {}
 
     /** Construct a copy of a queue. @version 1.0 */
-    MTQueue( const MTQueue< T, S >& from )  { *this = from; }
+    MTQueue( const MTQueue< T, S >& from ) : _size( 0 ) { *this = from; }
 
     /** Destruct this Queue. @version 1.0 */
     ~MTQueue() {}
@@ -67,10 +70,10 @@ public:
     const T& operator[]( const size_t index ) const;
 
     /** @return true if the queue is empty, false otherwise. @version 1.0 */
-    bool isEmpty() const { return _queue.empty(); }
+    bool isEmpty() const { return _size == 0; }
 
     /** @return the number of items currently in the queue. @version 1.0 */
-    size_t getSize() const { return _queue.size(); }
+    size_t getSize() const { return size_t( ssize_t( _size )); }
 
     /**
      * Set the new maximum size of the queue.
@@ -191,6 +194,14 @@ public:
     /** Push a new element to the back of the queue. @version 1.0 */
     void push( const T& element );
 
+    /**
+     * Push a new element to the back of the queue if it is not full.
+     *
+     * @return true if the element was pushed, false if the queue is full.
+     * @version 1.11
+     */
+    bool tryPush( const T& element );
+
     /** Push a vector of elements to the back of the queue. @version 1.0 */
     void push( const std::vector< T >& elements );
 
@@ -208,8 +219,11 @@ public:
 
 private:
     std::deque< T > _queue;
+    a_ssize_t _size; //!< _queue.size(), readable without the lock
     mutable Condition _cond;
     size_t _maxSize;
+
+    void _spin( unsigned timeout ) const;
 };
 }
 
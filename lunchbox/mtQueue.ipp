@@ -31,6 +31,7 @@ MTQueue< T, S >& MTQueue< T, S >::operator = ( const MTQueue< T, S >& from )
         _cond.lock();
         _maxSize = maxSize;
         _queue.swap( copy );
+        _size = ssize_t( _queue.size( ));
         _cond.signal();
         _cond.unlock();
     }
@@ -78,6 +79,7 @@ void MTQueue< T, S >::clear()
 {
     _cond.lock();
     _queue.clear();
+    _size = 0;
     _cond.signal();
     _cond.unlock();
 }
@@ -85,6 +87,7 @@ void MTQueue< T, S >::clear()
 template< typename T, size_t S >
 T MTQueue< T, S >::pop()
 {
+    _spin( LB_TIMEOUT_INDEFINITE );
     _cond.lock();
     while( _queue.empty( ))
         _cond.wait();
@@ -92,6 +95,7 @@ T MTQueue< T, S >::pop()
     LBASSERT( !_queue.empty( ));
     T element = _queue.front();
     _queue.pop_front();
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
     return element;
@@ -100,6 +104,7 @@ T MTQueue< T, S >::pop()
 template< typename T, size_t S >
 bool MTQueue< T, S >::timedPop( const unsigned timeout, T& element )
 {
+    _spin( timeout );
     _cond.lock();
     while( _queue.empty( ))
     {
@@ -112,6 +117,7 @@ bool MTQueue< T, S >::timedPop( const unsigned timeout, T& element )
     LBASSERT( !_queue.empty( ));
     element = _queue.front();
     _queue.pop_front();
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
     return true;
@@ -138,6 +144,7 @@ MTQueue< T, S >::timedPopRange( const unsigned timeout, const size_t minimum,
     result.reserve( size );
     result.insert( result.end(), _queue.begin(), _queue.begin() + size );
     _queue.erase( _queue.begin(), _queue.begin() + size );
+    _size = ssize_t( _queue.size( ));
 
     _cond.unlock();
     return result;
@@ -155,6 +162,7 @@ bool MTQueue< T, S >::tryPop( T& result )
 
     result = _queue.front();
     _queue.pop_front();
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
     return true;
@@ -173,6 +181,7 @@ void MTQueue< T, S >::tryPop( const size_t num, std::vector< T >& result )
             result.push_back( _queue.front( ));
             _queue.pop_front();
         }
+        _size = ssize_t( _queue.size( ));
         _cond.signal();
     }
     _cond.unlock();
@@ -216,6 +225,7 @@ bool MTQueue< T, S >::popBarrier( T& element, Group& barrier )
 
     element = _queue.front();
     _queue.pop_front();
+    _size = ssize_t( _queue.size( ));
     --barrier.waiting_;
     _cond.signal();
     _cond.unlock();
@@ -260,10 +270,28 @@ void MTQueue< T, S >::push( const T& element )
     while( _queue.size() >= _maxSize )
         _cond.wait();
     _queue.push_back( element );
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
 }
 
+template< typename T, size_t S >
+bool MTQueue< T, S >::tryPush( const T& element )
+{
+    _cond.lock();
+    if( _queue.size() >= _maxSize )
+    {
+        _cond.unlock();
+        return false;
+    }
+
+    _queue.push_back( element );
+    _size = ssize_t( _queue.size( ));
+    _cond.signal();
+    _cond.unlock();
+    return true;
+}
+
 template< typename T, size_t S >
 void MTQueue< T, S >::push( const std::vector< T >& elements )
 {
@@ -272,6 +300,7 @@ void MTQueue< T, S >::push( const std::vector< T >& elements )
     while( (_maxSize - _queue.size( )) < elements.size( ))
         _cond.wait();
     _queue.insert( _queue.end(), elements.begin(), elements.end( ));
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
 }
@@ -283,6 +312,7 @@ void MTQueue< T, S >::pushFront( const T& element )
     while( _queue.size() >= _maxSize )
         _cond.wait();
     _queue.push_front( element );
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
 }
@@ -295,7 +325,26 @@ void MTQueue< T, S >::pushFront( const std::vector< T >& elements )
     while( (_maxSize - _queue.size( )) < elements.size( ))
         _cond.wait();
     _queue.insert(_queue.begin(), elements.begin(), elements.end());
+    _size = ssize_t( _queue.size( ));
     _cond.signal();
     _cond.unlock();
 }
+
+// Poll an empty queue for a short time before blocking on the condition.
+// Timed pops only busy-wait, since yielding may exceed short timeouts.
+template< typename T, size_t S >
+void MTQueue< T, S >::_spin( const unsigned timeout ) const
+{
+    if( timeout == 0 )
+        return;
+
+    SpinWait spin;
+    while( timeout == LB_TIMEOUT_INDEFINITE ? !spin.shouldPark()
+                                            : !spin.willYield( ))
+    {
+        if( _size > 0 )
+            return;
+        spin.spinOnce();
+    }
+}
 }
@@ -22,6 +22,7 @@
 #include <lunchbox/api.h>
 #include <lunchbox/defines.h>
 #include <lunchbox/compiler.h>
+#include <lunchbox/parallelMemory.h>
 
 #ifdef _WIN32
 #  ifndef WIN32
@@ -80,6 +81,19 @@ static inline void setZero( void* ptr, const size_t size )
 #endif
 }
 
+/**
+ * Set size bytes to 0, using multiple threads for large ranges if parallel
+ * is true, see parallelSetZero().
+ * @version 1.11
+ */
+static inline void setZero( void* ptr, const size_t size, const bool parallel )
+{
+    if( parallel )
+        parallelSetZero( ptr, size );
+    else
+        setZero( ptr, size );
+}
+
 /** @return the local hostname. @version 1.9.2 */
 LUNCHBOX_API std::string getHostname();
 }
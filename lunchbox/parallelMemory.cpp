@@ -0,0 +1,285 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "parallelMemory.h"
+
+#include "atomic.h"
+#include "debug.h"
+#include "lock.h"
+#include "monitor.h"
+#include "mtQueue.h"
+#include "os.h"
+#include "scopedMutex.h"
+#include "thread.h"
+#include "detail/cores.h"
+
+#include <cstring>
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+    ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  define LB_STREAMING_STORES
+#  include <emmintrin.h>
+#endif
+
+namespace lunchbox
+{
+namespace
+{
+const size_t _threshold = 4 * LB_1MB;     // use workers from this size
+const size_t _minChunkSize = LB_1MB;      // minimum bytes per thread
+const size_t _streamThreshold = LB_64MB;  // bypass caches from this size
+const size_t _maxThreads = 8;             // saturates most memory systems
+
+struct Task
+{
+    Task() : to( 0 ), from( 0 ), size( 0 ), value( 0 ), stream( false ) {}
+
+    uint8_t* to;
+    const uint8_t* from; // 0 for set
+    size_t size;
+    int value;
+    bool stream;
+};
+
+#ifdef LB_STREAMING_STORES
+// Non-temporal stores need a 16-byte aligned destination; the unaligned head
+// and the tail are written normally.
+size_t _getHeadSize( const uint8_t* to, const size_t size )
+{
+    const size_t head = ( 16 - ( size_t( to ) & 15 )) & 15;
+    return head < size ? head : size;
+}
+
+void _streamCopy( uint8_t* to, const uint8_t* from, size_t size )
+{
+    const size_t head = _getHeadSize( to, size );
+    ::memcpy( to, from, head );
+    to += head;
+    from += head;
+    size -= head;
+
+    __m128i* out = reinterpret_cast< __m128i* >( to );
+    const __m128i* in = reinterpret_cast< const __m128i* >( from );
+    for( size_t i = size >> 4; i > 0; --i )
+        _mm_stream_si128( out++, _mm_loadu_si128( in++ ));
+    _mm_sfence();
+    ::memcpy( out, in, size & 15 );
+}
+
+void _streamSet( uint8_t* to, const int value, size_t size )
+{
+    const size_t head = _getHeadSize( to, size );
+    ::memset( to, value, head );
+    to += head;
+    size -= head;
+
+    __m128i* out = reinterpret_cast< __m128i* >( to );
+    const __m128i data = _mm_set1_epi8( char( value ));
+    for( size_t i = size >> 4; i > 0; --i )
+        _mm_stream_si128( out++, data );
+    _mm_sfence();
+    ::memset( out, value, size & 15 );
+}
+#endif
+
+void _execute( const Task& task )
+{
+#ifdef LB_STREAMING_STORES
+    if( task.stream )
+    {
+        if( task.from )
+            _streamCopy( task.to, task.from, task.size );
+        else
+            _streamSet( task.to, task.value, task.size );
+        return;
+    }
+#endif
+    if( task.from )
+        ::memcpy( task.to, task.from, task.size );
+    else
+        ::memset( task.to, task.value, task.size );
+}
+
+class Worker : public Thread
+{
+public:
+    Worker( Monitor< size_t >& done, const int32_t core )
+        : _done( done ), _core( core ) {}
+
+    MTQueue< Task > tasks; // a task without destination stops the worker
+
+protected:
+    virtual bool init()
+    {
+        setName( "MemoryWorker" );
+#ifdef LUNCHBOX_USE_HWLOC
+        setAffinity( Thread::CORE + _core );
+#endif
+        return true;
+    }
+
+    virtual void run()
+    {
+        for( ;; )
+        {
+            const Task task = tasks.pop();
+            if( !task.to )
+                return;
+            _execute( task );
+            ++_done;
+        }
+    }
+
+private:
+    Monitor< size_t >& _done;
+    const int32_t _core;
+};
+
+class Engine
+{
+public:
+    Engine()
+    {
+        const size_t nThreads = std::min( detail::getNCores(), _maxThreads );
+        for( size_t i = 1; i < nThreads; ++i ) // caller is the first thread
+        {
+            Worker* worker = new Worker( _done, int32_t( i ));
+            if( !worker->start( ))
+            {
+                delete worker;
+                break;
+            }
+            _workers.push_back( worker );
+        }
+    }
+
+    ~Engine()
+    {
+        for( size_t i = 0; i < _workers.size(); ++i )
+        {
+            _workers[ i ]->tasks.push( Task( ));
+            _workers[ i ]->join();
+            delete _workers[ i ];
+        }
+    }
+
+    void execute( const Task& task )
+    {
+        const size_t nChunks = std::min( _workers.size() + 1,
+                                         task.size / _minChunkSize );
+        if( nChunks < 2 || !_lock.trySet( ))
+        {
+            _execute( task );
+            return;
+        }
+
+        // cache-line-aligned chunks
+        const size_t chunkSize = (( task.size + nChunks - 1 ) / nChunks + 63 ) &
+                                 ~size_t( 63 );
+        _done = 0;
+        size_t nTasks = 0;
+        for( size_t offset = chunkSize; offset < task.size;
+             offset += chunkSize )
+        {
+            Task chunk = task;
+            chunk.to += offset;
+            if( chunk.from )
+                chunk.from += offset;
+            chunk.size = std::min( chunkSize, task.size - offset );
+            _workers[ nTasks++ ]->tasks.push( chunk );
+        }
+
+        Task first = task;
+        first.size = std::min( chunkSize, task.size );
+        _execute( first );
+        _done.waitEQ( nTasks );
+        _lock.unset();
+    }
+
+private:
+    std::vector< Worker* > _workers;
+    Monitor< size_t > _done;
+    Lock _lock; // one operation at a time
+};
+
+// Leaked to stay usable during static destruction, see
+// shutdownParallelMemory()
+Engine* _engine = 0;
+
+Lock& _getEngineLock()
+{
+    static Lock* lock = new Lock;
+    return *lock;
+}
+
+Engine& _getEngine()
+{
+    Engine* engine = _engine;
+    memoryBarrierAcquire();
+    if( engine )
+        return *engine;
+
+    ScopedWrite mutex( _getEngineLock( ));
+    if( !_engine )
+    {
+        engine = new Engine;
+        memoryBarrierRelease();
+        _engine = engine;
+    }
+    return *_engine;
+}
+
+void _run( const Task& task )
+{
+    if( task.size < _threshold )
+        _execute( task );
+    else
+        _getEngine().execute( task );
+}
+}
+
+void parallelCopy( void* to, const void* from, const size_t size )
+{
+    Task task;
+    task.to = static_cast< uint8_t* >( to );
+    task.from = static_cast< const uint8_t* >( from );
+    task.size = size;
+    task.stream = size >= _streamThreshold;
+    _run( task );
+}
+
+void parallelSet( void* ptr, const int value, const size_t size )
+{
+    Task task;
+    task.to = static_cast< uint8_t* >( ptr );
+    task.value = value;
+    task.size = size;
+    task.stream = size >= _streamThreshold;
+    _run( task );
+}
+
+size_t getParallelMemoryThreshold()
+{
+    return _threshold;
+}
+
+void shutdownParallelMemory()
+{
+    ScopedWrite mutex( _getEngineLock( ));
+    delete _engine;
+    _engine = 0;
+}
+}
@@ -0,0 +1,70 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_PARALLELMEMORY_H
+#define LUNCHBOX_PARALLELMEMORY_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+/**
+ * @file lunchbox/parallelMemory.h
+ *
+ * Copy and initialize large memory ranges using multiple threads.
+ *
+ * A single thread can not saturate the memory bandwidth of most machines.
+ * Ranges of at least getParallelMemoryThreshold() bytes are split across
+ * worker threads, which are created on first use and pinned to cores if
+ * Lunchbox is built with hwloc. Smaller ranges are copied by the calling
+ * thread using memcpy or memset. On x86 CPUs, ranges of at least 64 MB are
+ * written with non-temporal stores, which bypass the cache. This fixed size
+ * exceeds the last level cache of common CPUs, which is not queried.
+ *
+ * The workers are used by one operation at a time. Concurrent operations are
+ * executed by their calling thread only.
+ */
+
+namespace lunchbox
+{
+/** Copy size bytes, like memcpy, using multiple threads. @version 1.11 */
+LUNCHBOX_API void parallelCopy( void* to, const void* from, size_t size );
+
+/** Set size bytes, like memset, using multiple threads. @version 1.11 */
+LUNCHBOX_API void parallelSet( void* ptr, int value, size_t size );
+
+/** Set size bytes to 0 using multiple threads. @version 1.11 */
+inline void parallelSetZero( void* ptr, const size_t size )
+    { parallelSet( ptr, 0, size ); }
+
+/**
+ * @return the minimum size in bytes for which multiple threads are used.
+ * @version 1.11
+ */
+LUNCHBOX_API size_t getParallelMemoryThreshold();
+
+/**
+ * Stop the worker threads.
+ *
+ * The workers are never stopped automatically, and are restarted by the
+ * next parallel operation. Must not be called concurrently with parallel
+ * operations.
+ * @version 1.11
+ */
+LUNCHBOX_API void shutdownParallelMemory();
+}
+
+#endif // LUNCHBOX_PARALLELMEMORY_H
@@ -24,7 +24,13 @@
 
 namespace lunchbox
 {
-/** An object allocation pool. */
+/**
+ * An object allocation pool.
+ *
+ * @sa MagazinePool for a thread-safe pool with per-thread caches.
+ * @sa SlabPool for a pool allocating its items in contiguous chunks.
+ * @sa LFPool for a lock-free pool.
+ */
 template< typename T, bool locked = false >
 class Pool : public boost::noncopyable
 {
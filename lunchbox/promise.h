@@ -0,0 +1,293 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_PROMISE_H
+#define LUNCHBOX_PROMISE_H
+
+#include <lunchbox/atomic.h>     // member
+#include <lunchbox/future.h>     // used inline
+#include <lunchbox/monitor.h>    // member
+#include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinLock.h>   // member
+
+#include <boost/exception_ptr.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <vector>
+
+namespace lunchbox
+{
+/**
+ * The producing side of a Future.
+ *
+ * A promise is fulfilled once, either with a value or with an exception,
+ * from any thread. Waiting on its futures returns the value or rethrows the
+ * exception. Continuations attached using Future::then() are run by the
+ * thread fulfilling the promise. Copies of a promise share the same state.
+ *
+ * A pending promise can be cancelled through Future::cancel(), which fulfills
+ * it with a FutureCancelled exception. Producers call start() before
+ * computing the value to prevent cancellation afterwards. Destroying the last
+ * copy of an unfulfilled promise fulfills it with a BrokenPromise exception.
+ *
+ * Example: @include tests/future.cpp
+ */
+template< class T > class Promise
+{
+    class Impl;
+
+    // Stands in for the value of a Promise< void >
+    typedef typename
+    boost::mpl::if_< boost::is_same< T, void >, bool, T >::type value_t;
+
+public:
+    /** Construct a new, unfulfilled promise. @version 1.11 */
+    Promise();
+
+    /** Construct a copy sharing the given promise's state. @version 1.11 */
+    Promise( const Promise& from );
+
+    /** Destruct the promise, breaking it if last and unfulfilled. */
+    ~Promise();
+
+    /** Share the state of the given promise. @version 1.11 */
+    Promise& operator = ( const Promise& from );
+
+    /** @return a future on the result of this promise. @version 1.11 */
+    Future< T > getFuture() const;
+
+    /**
+     * Mark the promise as being fulfilled, disabling its cancellation.
+     *
+     * @return false if the promise was cancelled or fulfilled already.
+     * @version 1.11
+     */
+    bool start();
+
+    /**
+     * Fulfill the promise with the given value.
+     *
+     * The value is omitted for a Promise< void >.
+     * @return false if the promise was cancelled or fulfilled already, in
+     *         which case the value is discarded.
+     * @version 1.11
+     */
+    bool setValue( const value_t& value = value_t( ));
+
+    /**
+     * Fulfill the promise with the given exception.
+     *
+     * @return false if the promise was cancelled or fulfilled already.
+     * @version 1.11
+     */
+    bool setException( const boost::exception_ptr& exception );
+
+    /** @return true if the promise has been fulfilled. @version 1.11 */
+    bool isReady() const;
+
+private:
+    RefPtr< Impl > impl_;
+};
+}
+
+// Implementation
+
+namespace lunchbox
+{
+template< class T > class Promise< T >::Impl : public FutureImpl< T >
+{
+    typedef typename FutureImpl< T >::Callback Callback;
+    typedef std::vector< Callback > Callbacks;
+
+public:
+    Impl() : value_(), ready_( false ), producers_( 1 ), state_( PENDING ) {}
+
+    void addProducer() { ++producers_; }
+
+    void removeProducer()
+    {
+        if( --producers_ == 0 ) // fails unless fulfilled already
+            setException( boost::copy_exception( BrokenPromise( )));
+    }
+
+    bool start()
+    {
+        ScopedFastWrite mutex( lock_ );
+        if( state_ != PENDING )
+            return false;
+        state_ = STARTED;
+        return true;
+    }
+
+    bool setValue( const value_t& value )
+    {
+        Callbacks callbacks;
+        {
+            ScopedFastWrite mutex( lock_ );
+            if( state_ == FULFILLED )
+                return false;
+            value_ = value;
+            _fulfill( callbacks );
+        }
+        _notify( callbacks );
+        return true;
+    }
+
+    bool setException( const boost::exception_ptr& exception )
+    {
+        Callbacks callbacks;
+        {
+            ScopedFastWrite mutex( lock_ );
+            if( state_ == FULFILLED )
+                return false;
+            exception_ = exception;
+            _fulfill( callbacks );
+        }
+        _notify( callbacks );
+        return true;
+    }
+
+    T wait( const uint32_t timeout ) final
+    {
+        if( !ready_.timedWaitEQ( true, timeout ))
+            throw FutureTimeout();
+        if( exception_ )
+            boost::rethrow_exception( exception_ );
+        return static_cast< T >( value_ );
+    }
+
+    bool isReady() const final { return ready_.get(); }
+
+    void onReady( const Callback& callback ) final
+    {
+        {
+            ScopedFastWrite mutex( lock_ );
+            if( state_ != FULFILLED )
+            {
+                callbacks_.push_back( callback );
+                return;
+            }
+        }
+        callback();
+    }
+
+    bool cancel() final
+    {
+        Callbacks callbacks;
+        {
+            ScopedFastWrite mutex( lock_ );
+            if( state_ != PENDING )
+                return false;
+            exception_ = boost::copy_exception( FutureCancelled( ));
+            _fulfill( callbacks );
+        }
+        _notify( callbacks );
+        return true;
+    }
+
+private:
+    enum State
+    {
+        PENDING,
+        STARTED,
+        FULFILLED
+    };
+
+    value_t value_;
+    boost::exception_ptr exception_;
+    Monitor< bool > ready_;
+    a_int32_t producers_; // number of Promise copies
+
+    SpinLock lock_; // protects the following members and the result
+    State state_;
+    Callbacks callbacks_;
+
+    void _fulfill( Callbacks& callbacks )
+    {
+        state_ = FULFILLED;
+        callbacks.swap( callbacks_ );
+    }
+
+    void _notify( const Callbacks& callbacks )
+    {
+        ready_ = true;
+        for( typename Callbacks::const_iterator i = callbacks.begin();
+             i != callbacks.end(); ++i )
+        {
+            (*i)();
+        }
+    }
+};
+
+template< class T > inline Promise< T >::Promise()
+    : impl_( new Impl )
+{}
+
+template< class T > inline Promise< T >::Promise( const Promise& from )
+    : impl_( from.impl_ )
+{
+    impl_->addProducer();
+}
+
+template< class T > inline Promise< T >::~Promise()
+{
+    impl_->removeProducer();
+}
+
+template< class T > inline
+Promise< T >& Promise< T >::operator = ( const Promise& from )
+{
+    if( impl_ != from.impl_ )
+    {
+        RefPtr< Impl > impl = from.impl_;
+        impl->addProducer();
+        impl_->removeProducer();
+        impl_ = impl;
+    }
+    return *this;
+}
+
+template< class T > inline Future< T > Promise< T >::getFuture() const
+{
+    return Future< T >( impl_ );
+}
+
+template< class T > inline bool Promise< T >::start()
+{
+    return impl_->start();
+}
+
+template< class T > inline bool Promise< T >::setValue( const value_t& value )
+{
+    return impl_->setValue( value );
+}
+
+template< class T > inline
+bool Promise< T >::setException( const boost::exception_ptr& exception )
+{
+    return impl_->setException( exception );
+}
+
+template< class T > inline bool Promise< T >::isReady() const
+{
+    return impl_->isReady();
+}
+}
+
+#include "future.ipp" // Future template implementation
+
+#endif // LUNCHBOX_PROMISE_H
@@ -32,12 +32,10 @@ protected:
 };
 
 /** @return a boolean future being true. */
-inline Future< bool > makeTrueFuture()
-    { return Future< bool >( new FutureBool< true >); }
+inline Future< bool > makeTrueFuture() { return makeReadyFuture( true ); }
 
 /** @return a boolean future being false. */
-inline Future< bool > makeFalseFuture()
-    { return Future< bool >( new FutureBool< false >); }
+inline Future< bool > makeFalseFuture() { return makeReadyFuture( false ); }
 
 }
 #endif //LUNCHBOX_READYFUTURE_H
@@ -19,14 +19,21 @@
 #define LUNCHBOX_REQUEST_H
 
 #include <lunchbox/future.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/spinLock.h>
+#include <lunchbox/spinWait.h>
 #include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_pointer.hpp>
 #include <boost/type_traits/is_same.hpp>
+#include <vector>
 
 namespace lunchbox
 {
 
 /**
  * A Future implementation for a RequestHandler request.
+ *
+ * T has to be copy-constructible, see Future.
  * @version 1.9.1
  */
 template< class T > class Request : public Future< T >
@@ -51,6 +58,7 @@ public:
      *
      * If called, wait will not be called at destruction and wait() will throw.
      * If the future has already been resolved this function has no effect.
+     * Pending continuations are dropped, their futures throw BrokenPromise.
      * @version 1.9.1
      */
     void relinquish();
@@ -65,38 +73,60 @@ namespace lunchbox
 {
 template< class T > class Request< T >::Impl : public FutureImpl< T >
 {
-    typedef typename
-    boost::mpl::if_< boost::is_same< T, void >, void*, T >::type value_t;
+    typedef detail::IsBuiltinResult< T > isBuiltin_t;
+    typedef typename boost::mpl::if_c< boost::is_same< T, void >::value ||
+                                       boost::is_pointer< T >::value,
+                                       void*, T >::type value_t;
+    typedef typename FutureImpl< T >::Callback Callback;
+    typedef std::vector< Callback > Callbacks;
 
 public:
     Impl( RequestHandler& handler, const uint32_t req )
         : request( req )
-        , result( 0 )
+        , result()
         , handler_( handler )
         , done_( false )
         , relinquished_( false )
-    {}
-    virtual ~Impl() {}
+        , waiting_( false )
+        , deferred_( false )
+        , notified_( false )
+    {
+        if( !isBuiltin_t::value )
+            handler_.attachResult( request, &result, typeid( value_t ));
+    }
+
+    virtual ~Impl()
+    {
+        // stop serving into result, the request is unregistered when done
+        if( !done_ && !isBuiltin_t::value )
+            handler_.unregisterRequest( request );
+    }
 
     const uint32_t request;
     value_t result;
 
-    void relinquish() { relinquished_ = true; }
+    void relinquish()
+    {
+        Callbacks callbacks; // destroyed unlocked, breaking their promises
+        bool registered = false;
+        {
+            ScopedFastWrite mutex( lock_ );
+            relinquished_ = true;
+            registered = !notified_ && !callbacks_.empty();
+            callbacks.swap( callbacks_ );
+        }
+        // release the reference held for the handler, unless it notifies
+        if( registered && handler_.cancelNotify( request ))
+            this->unref();
+    }
+
     bool isRelinquished() const { return relinquished_; }
 
 protected:
     T wait( const uint32_t timeout ) final
     {
-        if( !done_ )
-        {
-            if( relinquished_ )
-                LBUNREACHABLE;
-
-            if ( !handler_.waitRequest( request, result, timeout ))
-                throw FutureTimeout();
-            done_ = true;
-        }
-        return result;
+        _wait( timeout );
+        return static_cast< T >( result );
     }
 
     bool isReady() const final
@@ -104,23 +134,122 @@ protected:
         return done_ || ( !relinquished_ && handler_.isRequestReady( request ));
     }
 
+    void onReady( const Callback& callback ) final
+    {
+        {
+            ScopedFastWrite mutex( lock_ );
+            if( relinquished_ )
+                return; // will never be notified
+            if( !notified_ )
+            {
+                callbacks_.push_back( callback );
+                if( callbacks_.size() > 1 )
+                    return;
+
+                // the handler holds a reference until it calls _notify
+                this->ref();
+                if( handler_.notifyRequest( request, &Impl::_notify, this ))
+                    return;
+                // served, timed out or unregistered already
+                this->unref();
+                notified_ = true;
+                callbacks_.clear();
+            }
+        }
+        callback();
+    }
+
 private:
     RequestHandler& handler_;
+    SpinLock lock_; // protects the following members
     bool done_; //!< waitRequest finished
     bool relinquished_;
-};
+    bool waiting_; //!< a thread is in waitRequest
+    bool deferred_; //!< _notify was called during the wait
+    bool notified_;
+    Callbacks callbacks_;
 
-template<> inline void Request< void >::Impl::wait( const uint32_t timeout )
-{
-    if( !done_ )
+    void _wait( const uint32_t timeout )
     {
+        if( !_beginWait( ))
+            return;
         if( relinquished_ )
             LBUNREACHABLE;
 
-        if ( !handler_.waitRequest( request, result, timeout ))
-            throw FutureTimeout();
-        done_ = true;
+        const bool served = _waitRequest( timeout, isBuiltin_t( ));
+        if( _endWait( served ))
+            _notify( this );
+        if( !served )
+            throw FutureTimeout(); // unregistered, will never be served
+    }
+
+    /** @return true once this thread waits on the request, false if done. */
+    bool _beginWait()
+    {
+        SpinWait spin;
+        while( true )
+        {
+            {
+                ScopedFastWrite mutex( lock_ );
+                if( done_ )
+                    return false;
+                if( !waiting_ )
+                {
+                    waiting_ = true;
+                    return true;
+                }
+            }
+            spin.spinOnce(); // another thread waits on the request
+        }
+    }
+
+    /** @return true if the notification was deferred during the wait. */
+    bool _endWait( const bool served )
+    {
+        ScopedFastWrite mutex( lock_ );
+        done_ = served;
+        waiting_ = false;
+        const bool deferred = deferred_;
+        deferred_ = false;
+        return deferred;
+    }
+
+    bool _waitRequest( const uint32_t timeout, boost::mpl::true_ )
+    {
+        return handler_.waitRequest( request, result, timeout );
+    }
+
+    bool _waitRequest( const uint32_t timeout, boost::mpl::false_ )
+    {
+        void* unused;
+        return handler_.waitRequest( request, unused, timeout );
+    }
+
+    static void _notify( void* impl )
+    {
+        Impl* self = static_cast< Impl* >( impl );
+        Callbacks callbacks;
+        {
+            ScopedFastWrite mutex( self->lock_ );
+            if( self->waiting_ )
+            {
+                // Called from the timed out wait or racing it. Continuations
+                // waiting on this request are run once the wait is done.
+                self->deferred_ = true;
+                return;
+            }
+            self->notified_ = true;
+            callbacks.swap( self->callbacks_ );
+        }
+        for( size_t i = 0; i < callbacks.size(); ++i )
+            callbacks[ i ]();
+        self->unref(); // taken in onReady()
     }
+};
+
+template<> inline void Request< void >::Impl::wait( const uint32_t timeout )
+{
+    _wait( timeout );
 }
 
 template< class T > inline
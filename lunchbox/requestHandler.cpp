@@ -17,27 +17,56 @@
 
 #include "requestHandler.h"
 
-#include "scopedMutex.h"
+#include "detail/futex.h"
 
 #include <lunchbox/debug.h>
-#include <lunchbox/stdExt.h>
-#include <lunchbox/spinLock.h>
-#include <lunchbox/timedLock.h>
+#include <lunchbox/log.h>
+#include <lunchbox/lfPool.h>
+#include <lunchbox/slotMap.h>
+#include <lunchbox/spinWait.h>
+#include <lunchbox/uint128_t.h>
 
-#include <list>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 
 namespace lunchbox
 {
 //! @cond IGNORE
 namespace
 {
+typedef Atomic< int32_t > Ops;
+typedef RequestHandler::Callback Callback;
+}
+
+namespace detail
+{
 struct Record
 {
-    Record() { lock.set(); }
+    enum State // bits of the state, 0 while pending
+    {
+        PENDING = 0,
+        WAITING = 1 << 0, // at least one thread is blocked on the request
+        NOTIFY = 1 << 1,  // callback is to be called when served
+        SERVED = 1 << 2
+    };
+
+    Record() : state( PENDING ), id( LB_UNDEFINED_UINT32 ), users( 0 )
+             , data( 0 ), typedResult( 0 ), type( 0 ), callback( 0 )
+             , callbackArg( 0 ) {}
     ~Record(){}
 
-    TimedLock lock;
-    void*     data;
+    int32_t state; // futex word, see State
+    int32_t id;    // identifier of the request using this record
+    int32_t users; // number of threads serving this record
+    void*   data;
+
+    // Result of a Request< T > with a non-builtin T, owned by the request
+    void* typedResult;
+    const std::type_info* type;
+
+    Callback callback;
+    void* callbackArg;
 
     union Result
     {
@@ -51,75 +80,213 @@ struct Record
         } rUint128;
     } result;
 };
-typedef stde::hash_map< uint32_t, Record* > RecordHash;
-typedef RecordHash::const_iterator RecordHashCIter;
-}
 
-namespace detail
-{
 class RequestHandler
 {
 public:
-    RequestHandler() : requestID( 1 ) {}
+    RequestHandler() {}
 
     uint32_t registerRequest( void* data )
     {
-        ScopedFastWrite mutex( lock );
+        Record* request = freeRecords.alloc();
+        request->state = Record::PENDING;
+        request->data = data;
+        request->typedResult = 0;
+        request->type = 0;
+        request->callback = 0;
 
-        Record* request;
-        if( freeRecords.empty( ))
-            request = new Record;
-        else
+        const uint32_t requestID = requests.insert( request );
+        if( requestID == LB_UNDEFINED_UINT32 )
         {
-            request = freeRecords.front();
-            freeRecords.pop_front();
+            freeRecords.release( request );
+            LBERROR << "Too many pending requests, at most "
+                    << size_t( SlotMap< Record* >::MAX_SIZE ) << " supported"
+                    << std::endl;
+            throw std::runtime_error( "Too many pending requests" );
         }
-
-        request->data = data;
-        requestID = ( requestID + 1 ) % LB_MAX_UINT32;
-        requests[ requestID ] = request;
+        request->id = int32_t( requestID );
         return requestID;
     }
 
-    bool waitRequest( const uint32_t requestID_, Record::Result& result,
-                      const uint32_t timeout )
+    Record* findRequest( const uint32_t requestID ) const
     {
-        result.rUint128.low = 0;
-        result.rUint128.high = 0;
         Record* request = 0;
+        if( requests.find( requestID, request ))
+            return request;
+        return 0;
+    }
+
+    /** @return the record of the request, protected from reuse, or 0. */
+    Record* claim( const uint32_t requestID )
+    {
+        Record* request = findRequest( requestID );
+        if( !request )
+            return 0;
+
+        // Pairs with unregisterRequest(): either we see the invalidated id,
+        // or the unregistering thread sees us as a user.
+        Ops::incAndGet( request->users );
+        if( detail::load( request->id ) == int32_t( requestID ))
+            return request;
+
+        Ops::decAndGet( request->users ); // recycled since the lookup
+        return 0;
+    }
+
+    /** @return the claimed record of a request with a builtin result. */
+    Record* claimBuiltin( const uint32_t requestID )
+    {
+        Record* request = claim( requestID );
+        if( !request || !request->type )
+            return request;
+
+        std::ostringstream error;
+        error << "Request " << requestID << " needs a result of type "
+              << request->type->name();
+        release( *request, false );
+        LBTHROW( std::runtime_error( error.str( )));
+    }
+
+    /** Release a claimed record, publishing its result if served. */
+    void release( Record& request, const bool served )
+    {
+        if( !served )
         {
-            ScopedFastWrite mutex( lock );
-            RecordHashCIter i = requests.find( requestID_ );
-            if( i == requests.end( ))
-                return false;
+            Ops::decAndGet( request.users );
+            return;
+        }
+
+        // The atomic update orders the result before the state
+        int32_t state = detail::load( request.state );
+        while( !Ops::compareAndSwap( &request.state, state, Record::SERVED ))
+            state = detail::load( request.state );
+
+        LBASSERTINFO( !( state & Record::SERVED ), "Request served twice" );
+        if( state & Record::WAITING )
+            detail::futexWake( &request.state,
+                               std::numeric_limits< int32_t >::max( ));
+
+        // The callback may wait on the request, which needs all users gone
+        const Callback callback = ( state & Record::NOTIFY ) ?
+                                  request.callback : 0;
+        void* const callbackArg = request.callbackArg;
+        Ops::decAndGet( request.users );
+        if( callback )
+            callback( callbackArg );
+    }
 
-            request = i->second;
+    bool notify( const uint32_t requestID,
+                 const Callback callback, void* arg )
+    {
+        Record* request = claim( requestID );
+        if( !request )
+            return false;
+
+        request->callback = callback;
+        request->callbackArg = arg;
+
+        // The atomic update orders the callback before the state
+        int32_t state = detail::load( request->state );
+        while( !( state & Record::SERVED ) &&
+               !Ops::compareAndSwap( &request->state, state,
+                                     state | Record::NOTIFY ))
+        {
+            state = detail::load( request->state );
         }
+        release( *request, false );
+        return !( state & Record::SERVED );
+    }
+
+    bool cancelNotify( const uint32_t requestID )
+    {
+        Record* request = claim( requestID );
+        if( !request )
+            return false;
+
+        int32_t state = detail::load( request->state );
+        while(( state & Record::NOTIFY ) &&
+              !Ops::compareAndSwap( &request->state, state,
+                                    state & ~Record::NOTIFY ))
+        {
+            state = detail::load( request->state );
+        }
+        release( *request, false );
+        return state & Record::NOTIFY;
+    }
+
+    bool waitRequest( const uint32_t requestID, Record::Result& result,
+                      const uint32_t timeout )
+    {
+        result.rUint128.low = 0;
+        result.rUint128.high = 0;
+        Record* request = findRequest( requestID );
+        if( !request )
+            return false;
 
-        const bool requestServed = request->lock.set( timeout );
+        const bool requestServed = _wait( *request, timeout );
         if( requestServed )
             result = request->result;
 
-        unregisterRequest( requestID_ );
+        unregisterRequest( requestID );
         return requestServed;
     }
 
-    void unregisterRequest( const uint32_t requestID_ )
+    void unregisterRequest( const uint32_t requestID )
     {
-        ScopedFastWrite mutex( lock );
-        RecordHash::iterator i = requests.find( requestID_ );
-        if( i == requests.end( ))
+        Record* request = 0;
+        if( !requests.erase( requestID, request ))
             return;
 
-        Record* request = i->second;
-        requests.erase( i );
-        freeRecords.push_front( request );
+        // Invalidate the record before waiting for the threads serving it,
+        // which may still write to its result.
+        Ops::compareAndSwap( &request->id, int32_t( requestID ),
+                             int32_t( LB_UNDEFINED_UINT32 ));
+        SpinWait spin;
+        while( detail::load( request->users ) > 0 )
+            spin.spinOnce();
+
+        // Serving clears NOTIFY, otherwise nobody will call the callback
+        const int32_t state = detail::load( request->state );
+        const Callback callback = ( state & Record::NOTIFY ) ?
+                                  request->callback : 0;
+        void* const callbackArg = request->callbackArg;
+        freeRecords.release( request );
+        if( callback )
+            callback( callbackArg );
     }
 
-    mutable lunchbox::SpinLock lock;
-    uint32_t requestID;
-    RecordHash requests;
-    std::list<Record*> freeRecords;
+    SlotMap< Record* > requests;
+    LFPool< Record > freeRecords;
+
+private:
+    bool _wait( Record& request, const uint32_t timeout )
+    {
+        const detail::Deadline deadline( timeout );
+        while( true )
+        {
+            int32_t state = detail::load( request.state );
+            if( state & Record::SERVED )
+                return true;
+
+            // announce the waiter, the server wakes only WAITING requests
+            if( !( state & Record::WAITING ))
+            {
+                if( !Ops::compareAndSwap( &request.state, state,
+                                          state | Record::WAITING ))
+                {
+                    continue;
+                }
+                state |= Record::WAITING;
+            }
+
+            const uint32_t remaining = deadline.getRemaining();
+            if( remaining == 0 ||
+                !detail::futexWait( &request.state, state, remaining ))
+            {
+                return detail::load( request.state ) & Record::SERVED;
+            }
+        }
+    }
 };
 }
 // @endcond
@@ -130,12 +297,6 @@ RequestHandler::RequestHandler()
 
 RequestHandler::~RequestHandler()
 {
-    while( !_impl->freeRecords.empty( ))
-    {
-        Record* request = _impl->freeRecords.front();
-        _impl->freeRecords.pop_front();
-        delete request;
-    }
     delete _impl;
 }
 
@@ -152,7 +313,7 @@ void RequestHandler::unregisterRequest( const uint32_t requestID )
 bool RequestHandler::waitRequest( const uint32_t requestID, void*& rPointer,
                                   const uint32_t timeout )
 {
-    Record::Result result;
+    detail::Record::Result result;
     if( !_impl->waitRequest( requestID, result, timeout ))
         return false;
 
@@ -162,7 +323,7 @@ bool RequestHandler::waitRequest( const uint32_t requestID, void*& rPointer,
 bool RequestHandler::waitRequest( const uint32_t requestID, uint32_t& rUint32,
                                   const uint32_t timeout )
 {
-    Record::Result result;
+    detail::Record::Result result;
     if( !_impl->waitRequest( requestID, result, timeout ))
         return false;
 
@@ -173,7 +334,7 @@ bool RequestHandler::waitRequest( const uint32_t requestID, uint32_t& rUint32,
 bool RequestHandler::waitRequest( const uint32_t requestID, uint128_t& rUint128,
                                   const uint32_t timeout )
 {
-    Record::Result result;
+    detail::Record::Result result;
     if( !_impl->waitRequest( requestID, result, timeout ))
         return false;
 
@@ -185,7 +346,7 @@ bool RequestHandler::waitRequest( const uint32_t requestID, uint128_t& rUint128,
 bool RequestHandler::waitRequest( const uint32_t requestID, bool& rBool,
                                   const uint32_t timeout )
 {
-    Record::Result result;
+    detail::Record::Result result;
     if( !_impl->waitRequest( requestID, result, timeout ))
         return false;
 
@@ -194,100 +355,112 @@ bool RequestHandler::waitRequest( const uint32_t requestID, bool& rBool,
 }
 bool RequestHandler::waitRequest( const uint32_t requestID )
 {
-    Record::Result result;
+    detail::Record::Result result;
     return _impl->waitRequest( requestID, result, LB_TIMEOUT_INDEFINITE );
 }
 
 void* RequestHandler::getRequestData( const uint32_t requestID )
 {
-    ScopedFastWrite mutex( _impl->lock );
-    RecordHashCIter i = _impl->requests.find( requestID );
-    if( i == _impl->requests.end( ))
-        return 0;
-
-    return i->second->data;
+    detail::Record* request = _impl->findRequest( requestID );
+    return request ? request->data : 0;
 }
 
 void RequestHandler::serveRequest( const uint32_t requestID, void* result )
 {
-    Record* request = 0;
-    {
-        ScopedFastWrite mutex( _impl->lock );
-        RecordHashCIter i = _impl->requests.find( requestID );
-
-        if( i != _impl->requests.end( ))
-            request = i->second;
-    }
+    detail::Record* request = _impl->claimBuiltin( requestID );
     if( request )
     {
         request->result.rPointer = result;
-        request->lock.unset();
+        _impl->release( *request, true );
     }
 }
 
 void RequestHandler::serveRequest( const uint32_t requestID, uint32_t result )
 {
-    Record* request = 0;
-    {
-        ScopedFastWrite mutex( _impl->lock );
-        RecordHashCIter i = _impl->requests.find( requestID );
-
-        if( i != _impl->requests.end( ))
-            request = i->second;
-    }
+    detail::Record* request = _impl->claimBuiltin( requestID );
     if( request )
     {
         request->result.rUint32 = result;
-        request->lock.unset();
+        _impl->release( *request, true );
     }
 }
 
 void RequestHandler::serveRequest( const uint32_t requestID, bool result )
 {
-    Record* request = 0;
-    {
-        ScopedFastWrite mutex( _impl->lock );
-        RecordHashCIter i = _impl->requests.find( requestID );
-
-        if( i != _impl->requests.end( ))
-            request = i->second;
-    }
+    detail::Record* request = _impl->claimBuiltin( requestID );
     if( request )
     {
         request->result.rBool = result;
-        request->lock.unset();
+        _impl->release( *request, true );
     }
 }
 
 void RequestHandler::serveRequest( const uint32_t requestID,
                                    const uint128_t& result )
 {
-    Record* request = 0;
+    detail::Record* request = _impl->claimBuiltin( requestID );
+    if( request )
     {
-        ScopedFastWrite mutex( _impl->lock );
-        RecordHashCIter i = _impl->requests.find( requestID );
-
-        if( i != _impl->requests.end( ))
-            request = i->second;
+        request->result.rUint128.low = result.low();
+        request->result.rUint128.high = result.high();
+        _impl->release( *request, true );
     }
+}
 
+void RequestHandler::attachResult( const uint32_t requestID, void* result,
+                                   const std::type_info& type )
+{
+    detail::Record* request = _impl->findRequest( requestID );
+    LBASSERT( request );
     if( request )
     {
-        request->result.rUint128.low = result.low();
-        request->result.rUint128.high = result.high();
-        request->lock.unset();
+        request->typedResult = result;
+        request->type = &type;
     }
 }
 
-bool RequestHandler::isRequestReady( const uint32_t requestID ) const
+void* RequestHandler::_claimResult( const uint32_t requestID,
+                                    const std::type_info& type,
+                                    detail::Record*& record )
 {
-    ScopedFastWrite mutex( _impl->lock );
-    RecordHashCIter i = _impl->requests.find( requestID );
-    if( i == _impl->requests.end( ))
-        return false;
+    record = _impl->claim( requestID );
+    if( !record )
+        return 0;
+
+    if( record->type && *record->type == type )
+        return record->typedResult;
+
+    std::ostringstream error;
+    error << "Request " << requestID << " needs a result of type "
+          << ( record->type ? record->type->name() : "void*, uint32_t, bool "
+                                                     "or uint128_t" )
+          << ", not " << type.name();
+    _impl->release( *record, false );
+    record = 0;
+    LBTHROW( std::runtime_error( error.str( )));
+}
 
-    Record* request = i->second;
-    return !request->lock.isSet();
+bool RequestHandler::notifyRequest( const uint32_t requestID,
+                                    const Callback callback, void* arg )
+{
+    return _impl->notify( requestID, callback, arg );
+}
+
+bool RequestHandler::cancelNotify( const uint32_t requestID )
+{
+    return _impl->cancelNotify( requestID );
+}
+
+void RequestHandler::_releaseResult( detail::Record* record, const bool served )
+{
+    _impl->release( *record, served );
+}
+
+bool RequestHandler::isRequestReady( const uint32_t requestID ) const
+{
+    const detail::Record* request = _impl->findRequest( requestID );
+    return request &&
+           ( detail::load( request->state ) & detail::Record::SERVED );
 }
 
 bool RequestHandler::hasPendingRequests() const
@@ -297,14 +470,8 @@ bool RequestHandler::hasPendingRequests() const
 
 std::ostream& operator << ( std::ostream& os, const detail::RequestHandler& rh )
 {
-    ScopedFastWrite mutex( rh.lock );
-    for( RecordHashCIter i = rh.requests.begin(); i != rh.requests.end(); ++i )
-    {
-        os << "request " << i->first << " served " << i->second->lock.isSet()
-           << std::endl;
-    }
-
-    return os;
+    // The slot map can't be traversed safely while requests are registered
+    return os << rh.requests.size() << " pending requests" << std::endl;
 }
 
 std::ostream& operator << ( std::ostream& os, const RequestHandler& rh )
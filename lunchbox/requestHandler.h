@@ -22,9 +22,32 @@
 #include <lunchbox/thread.h>    // thread-safety macros
 #include <lunchbox/types.h>
 
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <typeinfo>
+#ifdef CXX_RVALUE_REFERENCES_SUPPORTED
+#  include <utility>
+#endif
+
 namespace lunchbox
 {
-namespace detail { class RequestHandler; }
+namespace detail
+{
+class RequestHandler;
+struct Record;
+
+/** @internal Result types stored in the request record, not in the Request */
+template< class T > struct IsBuiltinResult
+    : public boost::mpl::bool_< boost::is_same< T, void >::value ||
+                                boost::is_pointer< T >::value ||
+                                boost::is_same< T, uint32_t >::value ||
+                                boost::is_same< T, bool >::value ||
+                                boost::is_same< T, uint128_t >::value >
+{};
+}
 
 /**
  * A thread-safe request handler.
@@ -33,6 +56,20 @@ namespace detail { class RequestHandler; }
  * thread registers a request, and later waits for the request to be
  * served. Another thread can serve the request, providing a result value.
  *
+ * Requests are kept in a lock-free SlotMap, registering, serving and waiting
+ * on requests does not take a handler-wide lock. Request identifiers carry
+ * a generation, identifiers of unregistered requests are ignored even after
+ * their slot has been reused.
+ *
+ * A Request< T > for any other type than void, pointers, uint32_t, bool and
+ * uint128_t receives its result directly from the templated serveRequest(),
+ * which moves (if supported) or copies the value into the request without
+ * an intermediate allocation. T still has to be copy-constructible, since
+ * Request::wait() returns a copy of the result; move-only types are not
+ * supported. The result has to be of type T; serving a request with a
+ * result of another type throws a std::runtime_error and leaves the request
+ * pending.
+ *
  * Thread-safety: The methods registerRequest(), unregisterRequest() and
  * waitRequest() are supposed to be called from one 'waiting' thread, and the
  * functions serveRequest() and deleteRequest() are supposed to be called only
@@ -55,6 +92,7 @@ public:
      * @param data a pointer to user-specific data for the request, can be
      *             0.
      * @return A Future which will be fulfilled on serveRequest().
+     * @throw std::runtime_error if SlotMap::MAX_SIZE requests are pending.
      * @version 1.9.1
      */
     template< class T > Request< T > registerRequest( void* data = 0 );
@@ -65,6 +103,7 @@ public:
      * @param data a pointer to user-specific data for the request, can be
      *             0.
      * @return the request identifier.
+     * @throw std::runtime_error if SlotMap::MAX_SIZE requests are pending.
      * @version 1.0
      * @deprecated use the future-based registerRequest()
      */
@@ -135,6 +174,8 @@ public:
      *
      * @param requestID the request identifier.
      * @param result the result of the request.
+     * @throw std::runtime_error if the request needs a result of type T
+     *        given to registerRequest< T >().
      * @version 1.0
      */
     LUNCHBOX_API void serveRequest( const uint32_t requestID,
@@ -147,6 +188,38 @@ public:
     /** Serve a request with an uint128_t result. @version 1.0 */
     LUNCHBOX_API void serveRequest( const uint32_t requestID,
                                     const uint128_t& result );
+
+#ifdef CXX_RVALUE_REFERENCES_SUPPORTED
+    /**
+     * Serve a Request< T > with a result of type T.
+     *
+     * The result is moved into the request if given as an rvalue, and
+     * copied otherwise. T has to be copy-constructible nevertheless.
+     *
+     * @param requestID the request identifier.
+     * @param result the result of the request.
+     * @throw std::runtime_error if the request is not a Request< T >.
+     * @version 1.11
+     */
+    template< class T > typename boost::disable_if<
+        detail::IsBuiltinResult< typename boost::decay< T >::type > >::type
+    serveRequest( const uint32_t requestID, T&& result );
+#else
+    /**
+     * Serve a Request< T > with a result of type T.
+     *
+     * Arrays, e.g., string literals, are served as pointers.
+     *
+     * @param requestID the request identifier.
+     * @param result the result of the request, copied into the request.
+     * @throw std::runtime_error if the request is not a Request< T >.
+     * @version 1.11
+     */
+    template< class T > typename boost::disable_if< detail::IsBuiltinResult<
+        typename boost::decay< const T >::type > >::type
+    serveRequest( const uint32_t requestID, const T& result );
+#endif
+
     /**
      * @return true if this request handler has pending requests.
      * @version 1.0
@@ -155,14 +228,52 @@ public:
 
     LUNCHBOX_API bool isRequestReady( const uint32_t ) const; //!< @internal
 
+    /** @internal A function called once a request is served. */
+    typedef void (*Callback)( void* arg );
+
+    /**
+     * @internal Call the given function once the request is served or gone.
+     *
+     * Used by Request< T > to notify continuations. At most one callback is
+     * registered per request. It is called exactly once, either from the
+     * thread serving the request, or from unregisterRequest() if the request
+     * is unregistered before being served, unless cancelled first.
+     * @return false if the request is unknown or already served, in which
+     *         case the callback is not called.
+     */
+    LUNCHBOX_API bool notifyRequest( uint32_t requestID, Callback callback,
+                                     void* arg );
+
+    /**
+     * @internal Remove the callback registered by notifyRequest().
+     *
+     * @return true if the callback was removed, false if it has been or is
+     *         being called.
+     */
+    LUNCHBOX_API bool cancelNotify( uint32_t requestID );
+
+    /** @internal Set the storage of a non-builtin Request< T > result. */
+    LUNCHBOX_API void attachResult( uint32_t requestID, void* result,
+                                    const std::type_info& type );
+
 private:
     detail::RequestHandler* const _impl;
     friend LUNCHBOX_API std::ostream& operator << ( std::ostream&,
                                                     const RequestHandler& );
     LUNCHBOX_API uint32_t _register( void* data );
+    LUNCHBOX_API void* _claimResult( uint32_t requestID,
+                                     const std::type_info& type,
+                                     detail::Record*& record );
+    LUNCHBOX_API void _releaseResult( detail::Record* record, bool served );
     LB_TS_VAR( _thread );
 };
 
+/**
+ * Print the number of pending requests.
+ *
+ * The requests themselves are not listed, since the lock-free request
+ * registry can not be traversed while other threads use it.
+ */
 LUNCHBOX_API std::ostream& operator << ( std::ostream&, const RequestHandler& );
 }
 
@@ -175,6 +286,54 @@ Request< T > RequestHandler::registerRequest( void* data )
 {
     return Request< T >( *this, _register( data ));
 }
+
+#ifdef CXX_RVALUE_REFERENCES_SUPPORTED
+template< class T > inline typename boost::disable_if<
+    detail::IsBuiltinResult< typename boost::decay< T >::type > >::type
+RequestHandler::serveRequest( const uint32_t requestID, T&& result )
+{
+    typedef typename boost::decay< T >::type value_t;
+    detail::Record* record = 0;
+    value_t* slot = static_cast< value_t* >(
+        _claimResult( requestID, typeid( value_t ), record ));
+    if( !slot )
+        return;
+
+    try
+    {
+        *slot = std::forward< T >( result );
+    }
+    catch( ... )
+    {
+        _releaseResult( record, false );
+        throw;
+    }
+    _releaseResult( record, true );
+}
+#else
+template< class T > inline typename boost::disable_if<
+    detail::IsBuiltinResult< typename boost::decay< const T >::type > >::type
+RequestHandler::serveRequest( const uint32_t requestID, const T& result )
+{
+    typedef typename boost::decay< const T >::type value_t;
+    detail::Record* record = 0;
+    value_t* slot = static_cast< value_t* >(
+        _claimResult( requestID, typeid( value_t ), record ));
+    if( !slot )
+        return;
+
+    try
+    {
+        *slot = result;
+    }
+    catch( ... )
+    {
+        _releaseResult( record, false );
+        throw;
+    }
+    _releaseResult( record, true );
+}
+#endif
 }
 
 #endif //LUNCHBOX_REQUESTHANDLER_H
@@ -0,0 +1,92 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "semaphore.h"
+
+#include "debug.h"
+#include "detail/futex.h"
+
+#include <limits>
+
+namespace lunchbox
+{
+namespace
+{
+typedef Atomic< int32_t > Ops;
+}
+
+Semaphore::Semaphore( const size_t count )
+    : _count( int32_t( count ))
+    , _nWaiters( 0 )
+{
+    LBASSERT( count <= size_t( std::numeric_limits< int32_t >::max( )));
+}
+
+Semaphore::~Semaphore()
+{
+    LBASSERTINFO( _nWaiters == 0, _nWaiters << " threads waiting" );
+}
+
+bool Semaphore::acquire( const uint32_t timeout )
+{
+    if( tryAcquire( ))
+        return true;
+
+    const detail::Deadline deadline( timeout );
+    Ops::incAndGet( _nWaiters );
+    bool acquired = true;
+    while( !tryAcquire( ))
+    {
+        const uint32_t remaining = deadline.getRemaining();
+        if( remaining == 0 || !detail::futexWait( &_count, 0, remaining ))
+        {
+            acquired = tryAcquire();
+            break;
+        }
+    }
+    Ops::decAndGet( _nWaiters );
+    return acquired;
+}
+
+bool Semaphore::tryAcquire()
+{
+    while( true )
+    {
+        const int32_t count = detail::load( _count );
+        if( count == 0 )
+            return false;
+        if( Ops::compareAndSwap( &_count, count, count - 1 ))
+            return true;
+    }
+}
+
+void Semaphore::release( const size_t n )
+{
+    Ops::getAndAdd( _count, int32_t( n ));
+
+    // The atomic update orders the count before reading the waiters, which
+    // count themselves before reading the count.
+    if( detail::load( _nWaiters ) > 0 )
+        detail::futexWake( &_count, int32_t( n ));
+}
+
+size_t Semaphore::getCount() const
+{
+    return size_t( detail::load( _count ));
+}
+
+}
@@ -0,0 +1,74 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SEMAPHORE_H
+#define LUNCHBOX_SEMAPHORE_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/types.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * A counting semaphore.
+ *
+ * Acquiring and releasing are lock-free while the semaphore has a count. Only
+ * threads finding a zero count block in the kernel, and releases only wake
+ * threads if any are blocked.
+ *
+ * Example: @include tests/semaphore.cpp
+ */
+class Semaphore : public boost::noncopyable
+{
+public:
+    /** Construct a new semaphore with the given count. @version 1.11 */
+    LUNCHBOX_API explicit Semaphore( size_t count = 0 );
+
+    /** Destruct the semaphore. No thread may wait on it. @version 1.11 */
+    LUNCHBOX_API ~Semaphore();
+
+    /**
+     * Decrement the count, waiting for a release if it is zero.
+     *
+     * @param timeout the timeout in milliseconds.
+     * @return true if the count was decremented, false on timeout.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool acquire( uint32_t timeout = LB_TIMEOUT_INDEFINITE );
+
+    /**
+     * Decrement the count if it is not zero, without waiting.
+     * @return true if the count was decremented, false otherwise.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool tryAcquire();
+
+    /** Increment the count, waking up to n waiters. @version 1.11 */
+    LUNCHBOX_API void release( size_t n = 1 );
+
+    /** @return the current count. @version 1.11 */
+    LUNCHBOX_API size_t getCount() const;
+
+private:
+    int32_t _count;
+    int32_t _nWaiters;
+};
+}
+
+#endif // LUNCHBOX_SEMAPHORE_H
@@ -0,0 +1,140 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SKIPLISTMAP_H
+#define LUNCHBOX_SKIPLISTMAP_H
+
+#include <lunchbox/atomic.h>         // member
+#include <lunchbox/debug.h>          // used inline
+#include <lunchbox/epochReclaimer.h> // member
+
+#include <boost/noncopyable.hpp>
+#include <functional>
+
+namespace lunchbox
+{
+/**
+ * A lock-free, ordered map based on a skip list.
+ *
+ * All operations are lock-free and may be called concurrently from any
+ * thread. Readers never block and never write to the nodes of the map. Erased
+ * nodes are reclaimed using an EpochReclaimer, which makes it safe to traverse
+ * the map while other threads erase elements.
+ *
+ * Keys and values are immutable once inserted; insert() does not overwrite
+ * existing elements. Values are returned by copy. Range iteration is done with
+ * forEach(), which visits the elements in key order. Concurrent modifications
+ * may or may not be observed by a running traversal, but each visited element
+ * was in the map at some point during the traversal.
+ *
+ * Example: @include tests/skipListMap.cpp
+ */
+template< class K, class V, class C = std::less< K > >
+class SkipListMap : public boost::noncopyable
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+
+    /** Construct a new, empty map. @version 1.11 */
+    SkipListMap();
+
+    /** Destruct the map. Not thread-safe. @version 1.11 */
+    ~SkipListMap();
+
+    /**
+     * Insert a new element.
+     *
+     * @return true if the element was inserted, false if the key exists.
+     * @version 1.11
+     */
+    bool insert( const K& key, const V& value );
+
+    /**
+     * Erase the element with the given key.
+     *
+     * @return true if this call erased the element, false if the key was not
+     *         found.
+     * @version 1.11
+     */
+    bool erase( const K& key );
+
+    /**
+     * Look up the value of the given key.
+     *
+     * @param key the key to look up.
+     * @param value set to a copy of the value if found, unmodified otherwise.
+     * @return true if the key was found, false otherwise.
+     * @version 1.11
+     */
+    bool find( const K& key, V& value ) const;
+
+    /** @return true if the key is in the map. @version 1.11 */
+    bool contains( const K& key ) const;
+
+    /**
+     * Look up the first element not less than the given key.
+     *
+     * @param key the key to search.
+     * @param foundKey set to the key of the element if found.
+     * @param value set to the value of the element if found.
+     * @return true if an element was found, false otherwise.
+     * @version 1.11
+     */
+    bool lowerBound( const K& key, K& foundKey, V& value ) const;
+
+    /**
+     * Visit all elements in the range [begin, end) in order.
+     *
+     * The functor is called as func( const K&, const V& ). It may modify this
+     * map, but will not observe its own modifications reliably.
+     *
+     * @return the number of visited elements.
+     * @version 1.11
+     */
+    template< class F >
+    size_t forEach( const K& begin, const K& end, F func ) const;
+
+    /** Visit all elements in order. @version 1.11 */
+    template< class F > size_t forEach( F func ) const;
+
+    /** @return the number of elements in the map. @version 1.11 */
+    size_t size() const { return size_t( ssize_t( _size )); }
+
+    /** @return true if the map is empty. @version 1.11 */
+    bool empty() const { return ssize_t( _size ) == 0; }
+
+private:
+    enum { MAX_HEIGHT = 24 };
+    struct Node;
+
+    Node* _head[ MAX_HEIGHT ];
+    a_ssize_t _size;
+    a_int32_t _seed;
+    EpochReclaimer _reclaimer;
+
+    bool _less( const K& a, const K& b ) const { return C()( a, b ); }
+    bool _find( const K& key, Node*** preds, Node** succs, bool cleanup );
+    Node* _lowerBound( const K& key ) const;
+    int32_t _getRandomHeight();
+    void _release( Node* node );
+};
+}
+
+#include "skipListMap.ipp" // template implementation
+
+#endif // LUNCHBOX_SKIPLISTMAP_H
@@ -0,0 +1,337 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <new>
+
+// The implementation follows the lock-free skip list of Herlihy & Shavit, "The
+// Art of Multiprocessor Programming", chapter 14.4. A node is logically deleted
+// by setting the lowest bit of its next pointers, top level first; the bottom
+// level mark decides which thread erased the node. Marked nodes are unlinked by
+// any writer traversing them. Since the inserting thread may still be linking
+// the upper levels of an erased node, inserter and eraser each hold one
+// ownership of the node, and the last one to finish unlinks it for good and
+// retires it to the EpochReclaimer.
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+template< class K, class V, class C > struct SkipListMap< K, V, C >::Node
+{
+    Node( const K& key_, const V& value_, const int32_t height_ )
+        : key( key_ ), value( value_ ), height( height_ ), owners( 2 )
+    {
+        for( int32_t i = 0; i < height; ++i )
+            next[ i ] = 0;
+    }
+
+    static void* operator new( size_t size, const int32_t height )
+        { return ::operator new( size + ( height - 1 ) * sizeof( Node* )); }
+    static void operator delete( void* ptr, const int32_t )
+        { ::operator delete( ptr ); }
+    static void operator delete( void* ptr ) { ::operator delete( ptr ); }
+
+    static Node* load( Node** link )
+        { return *static_cast< Node* volatile* >( link ); }
+    static bool cas( Node** link, Node* expected, Node* value )
+        { return Atomic< Node* >::compareAndSwap( link, expected, value ); }
+    static bool isMarked( Node* node )
+        { return reinterpret_cast< uintptr_t >( node ) & 1u; }
+    static Node* mark( Node* node )
+        { return reinterpret_cast< Node* >(
+                reinterpret_cast< uintptr_t >( node ) | 1u ); }
+    static Node* unmark( Node* node )
+        { return reinterpret_cast< Node* >(
+                reinterpret_cast< uintptr_t >( node ) & ~uintptr_t( 1 )); }
+
+    const K key;
+    const V value;
+    const int32_t height;
+    a_int32_t owners;
+    Node* next[1]; // allocated with height elements
+};
+/** @endcond */
+
+template< class K, class V, class C > SkipListMap< K, V, C >::SkipListMap()
+{
+    for( size_t i = 0; i < MAX_HEIGHT; ++i )
+        _head[ i ] = 0;
+}
+
+template< class K, class V, class C > SkipListMap< K, V, C >::~SkipListMap()
+{
+    Node* node = _head[ 0 ];
+    while( node )
+    {
+        LBASSERT( !Node::isMarked( node->next[ 0 ] ));
+        Node* next = node->next[ 0 ];
+        delete node;
+        node = next;
+    }
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::_find( const K& key, Node*** preds, Node** succs,
+                                    const bool cleanup )
+{
+retry:
+    Node** pred = _head;
+    Node* curr = 0;
+    for( int32_t level = MAX_HEIGHT - 1; level >= 0; --level )
+    {
+        curr = Node::unmark( Node::load( &pred[ level ] ));
+        while( curr )
+        {
+            Node* const succ = Node::load( &curr->next[ level ] );
+            if( Node::isMarked( succ ))
+            {
+                // curr is erased, unlink it on this level
+                if( !Node::cas( &pred[ level ], curr, Node::unmark( succ )))
+                    goto retry;
+                curr = Node::unmark( succ );
+                continue;
+            }
+
+            // cleanup also passes nodes with an equal key, an erased node may
+            // have been linked behind its replacement
+            if( _less( curr->key, key ) ||
+                ( cleanup && !_less( key, curr->key )))
+            {
+                pred = curr->next;
+                curr = succ;
+            }
+            else
+                break;
+        }
+        preds[ level ] = pred;
+        succs[ level ] = curr;
+    }
+    return curr && !_less( key, curr->key );
+}
+
+template< class K, class V, class C > typename SkipListMap< K, V, C >::Node*
+SkipListMap< K, V, C >::_lowerBound( const K& key ) const
+{
+    // Same traversal as _find(), but skipping instead of unlinking erased nodes
+    Node** pred = const_cast< Node** >( _head );
+    Node* curr = 0;
+    for( int32_t level = MAX_HEIGHT - 1; level >= 0; --level )
+    {
+        curr = Node::unmark( Node::load( &pred[ level ] ));
+        while( curr )
+        {
+            Node* const succ = Node::load( &curr->next[ level ] );
+            if( Node::isMarked( succ ))
+                curr = Node::unmark( succ );
+            else if( _less( curr->key, key ))
+            {
+                pred = curr->next;
+                curr = succ;
+            }
+            else
+                break;
+        }
+    }
+    return curr;
+}
+
+template< class K, class V, class C >
+int32_t SkipListMap< K, V, C >::_getRandomHeight()
+{
+    uint32_t bits = uint32_t( ++_seed ) * 2654435761u;
+    bits ^= bits >> 15;
+    bits *= 0x2c1b3c6du;
+    bits ^= bits >> 12;
+
+    int32_t height = 1;
+    while(( bits & 1 ) && height < MAX_HEIGHT )
+    {
+        ++height;
+        bits >>= 1;
+    }
+    return height;
+}
+
+template< class K, class V, class C >
+void SkipListMap< K, V, C >::_release( Node* node )
+{
+    if( --node->owners == 0 )
+        _reclaimer.retire( node );
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::insert( const K& key, const V& value )
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    Node** preds[ MAX_HEIGHT ];
+    Node* succs[ MAX_HEIGHT ];
+    const int32_t height = _getRandomHeight();
+    Node* node = 0;
+
+    for( ;; )
+    {
+        if( _find( key, preds, succs, false ))
+        {
+            delete node;
+            return false;
+        }
+
+        if( !node )
+            node = new( height ) Node( key, value, height );
+        for( int32_t i = 0; i < height; ++i )
+            node->next[ i ] = succs[ i ];
+
+        // linking the bottom level inserts the node
+        if( Node::cas( &preds[ 0 ][ 0 ], succs[ 0 ], node ))
+            break;
+    }
+    ++_size;
+
+    for( int32_t level = 1; level < height; ++level )
+    {
+        for( ;; )
+        {
+            Node* const succ = succs[ level ];
+            Node* const next = Node::load( &node->next[ level ] );
+            if( Node::isMarked( next ))
+                goto done; // erased concurrently
+            if( next != succ && !Node::cas( &node->next[ level ], next, succ ))
+                continue;
+            if( Node::cas( &preds[ level ][ level ], succ, node ))
+                break;
+
+            _find( key, preds, succs, false );
+            if( succs[ 0 ] != node )
+                goto done; // erased concurrently
+        }
+    }
+done:
+    // The eraser may have missed upper levels linked after its cleanup
+    if( Node::isMarked( Node::load( &node->next[ 0 ] )))
+        _find( key, preds, succs, true );
+    _release( node );
+    return true;
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::erase( const K& key )
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    Node** preds[ MAX_HEIGHT ];
+    Node* succs[ MAX_HEIGHT ];
+
+    if( !_find( key, preds, succs, false ))
+        return false;
+
+    Node* const node = succs[ 0 ];
+    for( int32_t level = node->height - 1; level > 0; --level )
+    {
+        Node* next = Node::load( &node->next[ level ] );
+        while( !Node::isMarked( next ))
+        {
+            Node::cas( &node->next[ level ], next, Node::mark( next ));
+            next = Node::load( &node->next[ level ] );
+        }
+    }
+
+    for( ;; )
+    {
+        Node* const next = Node::load( &node->next[ 0 ] );
+        if( Node::isMarked( next ))
+            return false; // erased by another thread
+        if( Node::cas( &node->next[ 0 ], next, Node::mark( next )))
+            break;
+    }
+    --_size;
+
+    _find( key, preds, succs, true );
+    _release( node );
+    return true;
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::find( const K& key, V& value ) const
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    const Node* node = _lowerBound( key );
+    if( !node || _less( key, node->key ))
+        return false;
+
+    value = node->value;
+    return true;
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::contains( const K& key ) const
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    const Node* node = _lowerBound( key );
+    return node && !_less( key, node->key );
+}
+
+template< class K, class V, class C >
+bool SkipListMap< K, V, C >::lowerBound( const K& key, K& foundKey,
+                                         V& value ) const
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    const Node* node = _lowerBound( key );
+    if( !node )
+        return false;
+
+    foundKey = node->key;
+    value = node->value;
+    return true;
+}
+
+template< class K, class V, class C > template< class F >
+size_t SkipListMap< K, V, C >::forEach( const K& begin, const K& end,
+                                        F func ) const
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    size_t count = 0;
+    for( Node* node = _lowerBound( begin );
+         node && _less( node->key, end ); )
+    {
+        Node* const next = Node::load( &node->next[ 0 ] );
+        if( !Node::isMarked( next ))
+        {
+            func( node->key, node->value );
+            ++count;
+        }
+        node = Node::unmark( next );
+    }
+    return count;
+}
+
+template< class K, class V, class C > template< class F >
+size_t SkipListMap< K, V, C >::forEach( F func ) const
+{
+    EpochReclaimer::Guard guard( _reclaimer );
+    size_t count = 0;
+    Node* node = Node::load( const_cast< Node** >( &_head[ 0 ] ));
+    while( node )
+    {
+        Node* const next = Node::load( &node->next[ 0 ] );
+        if( !Node::isMarked( next ))
+        {
+            func( node->key, node->value );
+            ++count;
+        }
+        node = Node::unmark( next );
+    }
+    return count;
+}
+}
@@ -0,0 +1,116 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SLABPOOL_H
+#define LUNCHBOX_SLABPOOL_H
+
+#include <lunchbox/scopedMutex.h> // used inline
+#include <lunchbox/spinLock.h>    // member
+#include <lunchbox/thread.h>      // thread-safety checks
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace lunchbox
+{
+/**
+ * An object allocation pool storing its items in contiguous chunks.
+ *
+ * Like Pool, items are constructed on first allocation and stay constructed
+ * while they are cached, so alloc() may return a previously used item. Instead
+ * of allocating each item separately, the pool allocates cache-line-aligned
+ * chunks of items and constructs the items in place. Items of the same chunk
+ * are adjacent in memory, which makes traversing pooled items cache-friendly
+ * and reduces heap fragmentation.
+ *
+ * reserve() constructs a given number of items upfront, avoiding allocations
+ * during a later burst of alloc() calls. A chunk whose items have all been
+ * released is destroyed, unless the pool would fall below the reserved number
+ * of items or no other chunk has free items.
+ *
+ * All items have to be released before the pool is destroyed. Items are
+ * allocated from the most recently used chunk first.
+ *
+ * Example: @include tests/slabPool.cpp
+ */
+template< class T, bool locked = false >
+class SlabPool : public boost::noncopyable
+{
+public:
+    /**
+     * Construct a new pool.
+     *
+     * @param chunkSize the number of items per chunk.
+     * @version 1.11
+     */
+    explicit SlabPool( size_t chunkSize = 64 );
+
+    /** Destruct this pool. @version 1.11 */
+    ~SlabPool();
+
+    /** @return a reusable or new item. @version 1.11 */
+    T* alloc();
+
+    /** Release an item for reuse. @version 1.11 */
+    void release( T* item );
+
+    /**
+     * Construct items until the given number of items is available.
+     *
+     * Items are constructed in whole chunks. Chunks are not destroyed as long
+     * as this would drop the number of available items below this number.
+     * @version 1.11
+     */
+    void reserve( size_t nItems );
+
+    /**
+     * Destroy all chunks whose items are not in use.
+     *
+     * Also resets the reserved number of items.
+     * @version 1.11
+     */
+    void flush();
+
+    /** @return the number of items handed out by alloc(). @version 1.11 */
+    size_t getNUsed() const { return _nUsed; }
+
+    /** @return the number of allocated chunks. @version 1.11 */
+    size_t getNChunks() const { return _chunks.size(); }
+
+    /** @return the number of items per chunk. @version 1.11 */
+    size_t getChunkSize() const { return _chunkSize; }
+
+private:
+    struct Chunk;
+    struct Slot;
+
+    const size_t _chunkSize;
+    SpinLock* const _lock;
+    std::vector< Chunk* > _chunks;
+    std::vector< Chunk* > _available; // chunks with free or unused slots
+    size_t _nUsed;
+    size_t _nReserved;
+    LB_TS_VAR( _thread );
+
+    Chunk* _newChunk();
+    void _deleteChunk( Chunk* chunk );
+};
+}
+
+#include "slabPool.ipp" // template implementation
+
+#endif // LUNCHBOX_SLABPOOL_H
@@ -0,0 +1,215 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/log.h>
+
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <algorithm> // std::find
+#include <new>       // placement new
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+namespace detail
+{
+static const size_t slabAlignment = 64; // cache line size
+}
+
+// Slots [0, nConstructed) of a chunk hold constructed items, which are either
+// in use or in the free list of the chunk.
+template< class T, bool locked > struct SlabPool< T, locked >::Slot
+{
+    T* get() { return reinterpret_cast< T* >( &storage ); }
+
+    typename boost::aligned_storage< sizeof( T ),
+                                     boost::alignment_of< T >::value >::type
+        storage; // first member, item and slot addresses are the same
+    Chunk* chunk;
+};
+
+template< class T, bool locked > struct SlabPool< T, locked >::Chunk
+{
+    explicit Chunk( const size_t size )
+        : memory( ::operator new( size * sizeof( Slot ) +
+                                  detail::slabAlignment ))
+        , slots( reinterpret_cast< Slot* >(
+                     ( reinterpret_cast< uintptr_t >( memory ) +
+                       detail::slabAlignment - 1 ) &
+                     ~uintptr_t( detail::slabAlignment - 1 )))
+        , nConstructed( 0 )
+        , isAvailable( true )
+    {
+        for( size_t i = 0; i < size; ++i )
+            slots[ i ].chunk = this;
+        free.reserve( size );
+    }
+
+    ~Chunk()
+    {
+        for( size_t i = 0; i < nConstructed; ++i )
+            slots[ i ].get()->~T();
+        ::operator delete( memory );
+    }
+
+    size_t getNUsed() const { return nConstructed - free.size(); }
+
+    void* const memory;
+    Slot* const slots;
+    size_t nConstructed;
+    std::vector< Slot* > free;
+    bool isAvailable;
+};
+/** @endcond */
+
+template< class T, bool locked >
+SlabPool< T, locked >::SlabPool( const size_t chunkSize )
+    : _chunkSize( chunkSize )
+    , _lock( locked ? new SpinLock : 0 )
+    , _nUsed( 0 )
+    , _nReserved( 0 )
+{
+    LBASSERT( chunkSize > 0 );
+}
+
+template< class T, bool locked > SlabPool< T, locked >::~SlabPool()
+{
+    flush();
+    if( _nUsed > 0 )
+        LBWARN << _nUsed << " items still in use when destroying slab pool"
+               << std::endl;
+    while( !_chunks.empty( ))
+        _deleteChunk( _chunks.back( ));
+    delete _lock;
+}
+
+template< class T, bool locked > T* SlabPool< T, locked >::alloc()
+{
+    ScopedFastWrite mutex( _lock );
+    LB_TS_SCOPED( _thread );
+    if( _available.empty( ))
+        _newChunk();
+
+    Chunk* chunk = _available.back();
+    Slot* slot;
+    if( chunk->free.empty( ))
+    {
+        slot = &chunk->slots[ chunk->nConstructed ];
+        new( slot->get( )) T;
+        ++chunk->nConstructed;
+    }
+    else
+    {
+        slot = chunk->free.back();
+        chunk->free.pop_back();
+    }
+
+    if( chunk->free.empty() && chunk->nConstructed == _chunkSize )
+    {
+        _available.pop_back();
+        chunk->isAvailable = false;
+    }
+    ++_nUsed;
+    return slot->get();
+}
+
+template< class T, bool locked > void SlabPool< T, locked >::release( T* item )
+{
+    ScopedFastWrite mutex( _lock );
+    LB_TS_SCOPED( _thread );
+    LBASSERT( _nUsed > 0 );
+
+    Slot* slot = reinterpret_cast< Slot* >( item );
+    Chunk* chunk = slot->chunk;
+    chunk->free.push_back( slot );
+    --_nUsed;
+
+    if( !chunk->isAvailable )
+    {
+        _available.push_back( chunk );
+        chunk->isAvailable = true;
+    }
+
+    // Keep the chunk if it is the only one with free items, to avoid
+    // destroying and recreating it in an alloc/release loop
+    if( chunk->getNUsed() == 0 && _available.size() > 1 &&
+        ( _chunks.size() - 1 ) * _chunkSize >= _nUsed + _nReserved )
+    {
+        _deleteChunk( chunk );
+    }
+}
+
+template< class T, bool locked >
+void SlabPool< T, locked >::reserve( const size_t nItems )
+{
+    ScopedFastWrite mutex( _lock );
+    LB_TS_SCOPED( _thread );
+    _nReserved = nItems;
+
+    size_t nFree = 0;
+    for( size_t i = 0; i < _chunks.size(); ++i )
+        nFree += _chunks[ i ]->free.size();
+
+    // construct whole chunks, alloc() would otherwise construct new items in
+    // a partially constructed chunk before using free items of other chunks
+    for( size_t i = 0; nFree < nItems; ++i )
+    {
+        if( i == _available.size( ))
+            _newChunk();
+
+        Chunk* chunk = _available[ i ];
+        for( ; chunk->nConstructed < _chunkSize; ++chunk->nConstructed )
+        {
+            Slot* slot = &chunk->slots[ chunk->nConstructed ];
+            new( slot->get( )) T;
+            chunk->free.push_back( slot );
+            ++nFree;
+        }
+    }
+}
+
+template< class T, bool locked > void SlabPool< T, locked >::flush()
+{
+    ScopedFastWrite mutex( _lock );
+    LB_TS_SCOPED( _thread );
+    _nReserved = 0;
+
+    const std::vector< Chunk* > chunks( _chunks );
+    for( size_t i = 0; i < chunks.size(); ++i )
+        if( chunks[ i ]->getNUsed() == 0 )
+            _deleteChunk( chunks[ i ] );
+}
+
+template< class T, bool locked >
+typename SlabPool< T, locked >::Chunk* SlabPool< T, locked >::_newChunk()
+{
+    Chunk* chunk = new Chunk( _chunkSize );
+    _chunks.push_back( chunk );
+    _available.push_back( chunk );
+    return chunk;
+}
+
+template< class T, bool locked >
+void SlabPool< T, locked >::_deleteChunk( Chunk* chunk )
+{
+    _chunks.erase( std::find( _chunks.begin(), _chunks.end(), chunk ));
+    if( chunk->isAvailable )
+        _available.erase( std::find( _available.begin(), _available.end(),
+                                     chunk ));
+    delete chunk;
+}
+}
@@ -0,0 +1,146 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SLOTMAP_H
+#define LUNCHBOX_SLOTMAP_H
+
+#include <lunchbox/atomic.h> // member
+#include <lunchbox/debug.h>  // used inline
+
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+
+namespace lunchbox
+{
+/**
+ * A thread-safe registry handing out 32-bit identifiers for stored values.
+ *
+ * Values are stored in a slot array which grows in fixed-size chunks and never
+ * moves. An identifier encodes the slot index in its lower INDEX_BITS bits and
+ * a generation in the remaining bits. The generation of a slot is incremented
+ * when its value is erased, which invalidates all identifiers previously handed
+ * out for the slot. Stale identifiers are detected, unless the same slot has
+ * been reused 2^GENERATION_BITS times in the meantime.
+ *
+ * All operations are lock-free. Lookups read the slot optimistically and
+ * validate the generation afterwards, therefore the value type has to be
+ * trivially copyable, e.g., a pointer or an integer. Erased slots are reused
+ * through a lock-free free list. Identifiers are never 0 or LB_UNDEFINED_UINT32.
+ *
+ * Example: @include tests/slotMap.cpp
+ */
+template< class T > class SlotMap : public boost::noncopyable
+{
+    BOOST_STATIC_ASSERT(( boost::has_trivial_copy< T >::value ));
+
+public:
+    typedef T mapped_type;
+
+    enum
+    {
+        INDEX_BITS = 20, //!< Identifier bits encoding the slot index
+        GENERATION_BITS = 32 - INDEX_BITS, //!< Remaining generation bits
+        MAX_SIZE = ( 1u << INDEX_BITS ) - 1 //!< The maximum number of slots
+    };
+
+    /** Construct a new, empty slot map. @version 1.11 */
+    SlotMap();
+
+    /** Destruct the slot map. Not thread-safe. @version 1.11 */
+    ~SlotMap();
+
+    /**
+     * Store a new value.
+     *
+     * @return the identifier of the value, or LB_UNDEFINED_UINT32 if all
+     *         MAX_SIZE slots are used.
+     * @version 1.11
+     */
+    uint32_t insert( const T& value );
+
+    /**
+     * Erase the value with the given identifier.
+     *
+     * @return true if this call erased the value, false if the identifier is
+     *         stale or unknown.
+     * @version 1.11
+     */
+    bool erase( const uint32_t id );
+
+    /**
+     * Erase the value with the given identifier.
+     *
+     * @param id the identifier.
+     * @param value set to the erased value on success, undefined otherwise.
+     * @return true if this call erased the value, false if the identifier is
+     *         stale or unknown.
+     * @version 1.11
+     */
+    bool erase( const uint32_t id, T& value );
+
+    /**
+     * Look up the value with the given identifier.
+     *
+     * @param id the identifier.
+     * @param value set to the value on success, undefined otherwise.
+     * @return true if the identifier is valid, false otherwise.
+     * @version 1.11
+     */
+    bool find( const uint32_t id, T& value ) const;
+
+    /** @return true if the identifier is valid. @version 1.11 */
+    bool contains( const uint32_t id ) const;
+
+    /** @return the number of stored values. @version 1.11 */
+    size_t size() const { return size_t( int32_t( _size )); }
+
+    /** @return true if no values are stored. @version 1.11 */
+    bool empty() const { return int32_t( _size ) == 0; }
+
+    /** @return the number of slots used so far. @version 1.11 */
+    size_t getCapacity() const { return size_t( int32_t( _end )); }
+
+    /** @return the slot index encoded in an identifier. @version 1.11 */
+    static uint32_t getIndex( const uint32_t id ) { return id & INDEX_MASK; }
+
+private:
+    enum
+    {
+        INDEX_MASK = MAX_SIZE,
+        CHUNK_BITS = 10,
+        CHUNK_SIZE = 1 << CHUNK_BITS,
+        NCHUNKS = ( 1 << INDEX_BITS ) / CHUNK_SIZE
+    };
+
+    struct Slot;
+
+    Slot* _chunks[ NCHUNKS ];
+    a_int32_t _end;      // number of slots handed out
+    a_int32_t _size;
+    a_int32_t _freeList; // identifier of the first free slot, or 0
+
+    Slot* _getSlot( const uint32_t id ) const;
+    bool _allocate( uint32_t& index );
+    bool _pop( uint32_t& index );
+    void _push( const uint32_t index, const uint32_t generation );
+};
+}
+
+#include "slotMap.ipp" // template implementation
+
+#endif // LUNCHBOX_SLOTMAP_H
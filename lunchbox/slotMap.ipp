@@ -0,0 +1,218 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Each slot has a version holding its generation and a used bit. The free list
+// is a stack of free slots, linked through the identifiers they will hand out
+// next. Since the generation of a slot changes on each erase, a slot pushed
+// again has a different identifier, which avoids the ABA problem of the stack.
+
+namespace lunchbox
+{
+/** @cond IGNORE */
+namespace detail
+{
+static const uint32_t slotGenerationMask = ( 1u << ( 32 - 20 )) - 1;
+
+inline uint32_t getSlotGeneration( const int32_t version )
+{
+    return uint32_t( version ) >> 1;
+}
+
+inline uint32_t getNextSlotGeneration( uint32_t generation )
+{
+    // skip generation 0, which would allow the identifier 0
+    if(( ++generation & slotGenerationMask ) == 0 )
+        ++generation;
+    return generation;
+}
+
+inline int32_t makeSlotVersion( const uint32_t generation, const bool used )
+{
+    return int32_t(( generation << 1 ) | ( used ? 1u : 0u ));
+}
+}
+
+template< class T > struct SlotMap< T >::Slot
+{
+    Slot() : version( detail::makeSlotVersion( 1, false )), next( 0 ), value()
+    {}
+
+    a_int32_t version;
+    int32_t next; // identifier of the next free slot
+    T value;
+};
+/** @endcond */
+
+template< class T > SlotMap< T >::SlotMap()
+    : _end( 0 )
+    , _size( 0 )
+    , _freeList( 0 )
+{
+    BOOST_STATIC_ASSERT( GENERATION_BITS == 12 ); // see slotGenerationMask
+    for( size_t i = 0; i < NCHUNKS; ++i )
+        _chunks[ i ] = 0;
+}
+
+template< class T > SlotMap< T >::~SlotMap()
+{
+    for( size_t i = 0; i < NCHUNKS; ++i )
+        delete [] _chunks[ i ];
+}
+
+template< class T >
+typename SlotMap< T >::Slot* SlotMap< T >::_getSlot( const uint32_t id ) const
+{
+    const uint32_t index = getIndex( id );
+    if( index >= uint32_t( int32_t( _end )))
+        return 0;
+
+    Slot* const chunk = *static_cast< Slot* const volatile* >(
+        &_chunks[ index >> CHUNK_BITS ] );
+    if( !chunk ) // being allocated
+        return 0;
+    return &chunk[ index & ( CHUNK_SIZE - 1 ) ];
+}
+
+template< class T > bool SlotMap< T >::_allocate( uint32_t& index )
+{
+    int32_t end;
+    do
+    {
+        end = _end;
+        if( end >= int32_t( MAX_SIZE ))
+            return false;
+    }
+    while( !_end.compareAndSwap( end, end + 1 ));
+
+    index = uint32_t( end );
+    Slot*& chunk = _chunks[ index >> CHUNK_BITS ];
+    if( *static_cast< Slot* volatile* >( &chunk ))
+        return true;
+
+    Slot* const newChunk = new Slot[ CHUNK_SIZE ];
+    if( !Atomic< Slot* >::compareAndSwap( &chunk, 0, newChunk ))
+        delete [] newChunk;
+    return true;
+}
+
+template< class T > bool SlotMap< T >::_pop( uint32_t& index )
+{
+    for( ;; )
+    {
+        const int32_t head = _freeList;
+        if( head == 0 )
+            return false;
+
+        const Slot* slot = _getSlot( head );
+        LBASSERT( slot );
+        const int32_t next = *static_cast< const volatile int32_t* >(
+            &slot->next );
+        if( _freeList.compareAndSwap( head, next ))
+        {
+            index = getIndex( head );
+            return true;
+        }
+    }
+}
+
+template< class T >
+void SlotMap< T >::_push( const uint32_t index, const uint32_t generation )
+{
+    Slot* slot = _getSlot( index );
+    const int32_t id = int32_t((( generation & detail::slotGenerationMask )
+                                << INDEX_BITS ) | index );
+    for( ;; )
+    {
+        const int32_t head = _freeList;
+        slot->next = head;
+        if( _freeList.compareAndSwap( head, id ))
+            return;
+    }
+}
+
+template< class T > uint32_t SlotMap< T >::insert( const T& value )
+{
+    uint32_t index = 0;
+    if( !_pop( index ) && !_allocate( index ))
+        return LB_UNDEFINED_UINT32;
+
+    Slot* slot = _getSlot( index );
+    LBASSERT( slot );
+    const uint32_t generation = detail::getSlotGeneration( slot->version );
+    slot->value = value;
+    slot->version = detail::makeSlotVersion( generation, true ); // publish
+    ++_size;
+    return (( generation & detail::slotGenerationMask ) << INDEX_BITS ) | index;
+}
+
+template< class T > bool SlotMap< T >::erase( const uint32_t id )
+{
+    T value;
+    return erase( id, value );
+}
+
+template< class T > bool SlotMap< T >::erase( const uint32_t id, T& value )
+{
+    Slot* slot = _getSlot( id );
+    if( !slot )
+        return false;
+
+    const int32_t version = slot->version;
+    const uint32_t generation = detail::getSlotGeneration( version );
+    if( !( version & 1 ) ||
+        ( generation & detail::slotGenerationMask ) != id >> INDEX_BITS )
+    {
+        return false;
+    }
+
+    value = slot->value; // before the slot may be reused
+    const uint32_t next = detail::getNextSlotGeneration( generation );
+    if( !slot->version.compareAndSwap( version,
+                                       detail::makeSlotVersion( next, false )))
+    {
+        return false;
+    }
+    --_size;
+    _push( getIndex( id ), next );
+    return true;
+}
+
+template< class T >
+bool SlotMap< T >::find( const uint32_t id, T& value ) const
+{
+    const Slot* slot = _getSlot( id );
+    if( !slot )
+        return false;
+
+    const int32_t version = slot->version;
+    if( !( version & 1 ) || ( detail::getSlotGeneration( version ) &
+                              detail::slotGenerationMask ) != id >> INDEX_BITS )
+    {
+        return false;
+    }
+
+    memoryBarrierAcquire();
+    value = slot->value;
+    return int32_t( slot->version ) == version; // not erased while copying
+}
+
+template< class T > bool SlotMap< T >::contains( const uint32_t id ) const
+{
+    T value;
+    return find( id, value );
+}
+}
@@ -0,0 +1,195 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SMALLBUFFER_H
+#define LUNCHBOX_SMALLBUFFER_H
+
+#include <lunchbox/allocator.h>   // default template parameter
+#include <lunchbox/debug.h>       // LBASSERT macro
+#include <lunchbox/os.h>          // setZero used inline
+
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <cstring>      // for memcpy
+#include <new>          // for std::bad_alloc
+
+namespace lunchbox
+{
+/**
+ * A memory buffer with inline storage for small contents.
+ *
+ * Provides the same interface and semantics as Buffer, but stores up to N
+ * elements inside the object itself. Memory is only allocated using the
+ * allocation policy A once the buffer grows beyond N elements, which avoids
+ * any heap allocation for small contents, e.g., command packets.
+ *
+ * Unlike Buffer, getData() never returns 0, and the maximum size is never
+ * below N. pack() moves the contents back into the inline storage when they
+ * fit. Moving or swapping inline contents copies them.
+ *
+ * Example: @include tests/smallBuffer.cpp
+ */
+template< class T, size_t N, class A = MallocAllocator > class SmallBuffer
+{
+public:
+    /** Construct a new, empty buffer. @version 1.11 */
+    SmallBuffer() : _data( _getInline( )), _size( 0 ), _maxSize( N ) {}
+
+    /** Construct a new buffer of the given size. @version 1.11 */
+    explicit SmallBuffer( const uint64_t size )
+        : _data( _getInline( )), _size( 0 ), _maxSize( N ) { reset( size ); }
+
+    /** "Move" constructor, transfers ownership to new buffer. @version 1.11 */
+    explicit SmallBuffer( SmallBuffer& from );
+
+    /** Destruct the buffer. @version 1.11 */
+    ~SmallBuffer() { clear(); }
+
+    /** Flush the buffer, deleting all heap data. @version 1.11 */
+    void clear();
+
+    /**
+     * Tighten the allocated memory to the size of the buffer.
+     * @return the new pointer to the first element.
+     * @version 1.11
+     */
+    T* pack();
+
+    /** Assignment operator, copies data from buffer. @version 1.11 */
+    SmallBuffer& operator = ( const SmallBuffer& from );
+
+    /** Direct access to the element at the given index. @version 1.11 */
+    T& operator [] ( const uint64_t position )
+        { LBASSERT( _size > position ); return _data[ position ]; }
+
+    /** Direct const access to an element. @version 1.11 */
+    const T& operator [] ( const uint64_t position ) const
+        { LBASSERT( _size > position ); return _data[ position ]; }
+
+    /**
+     * Ensure that the buffer contains at least newSize elements.
+     *
+     * Existing data is retained. The size is set.
+     * @return the new pointer to the first element.
+     * @version 1.11
+     */
+    T* resize( const uint64_t newSize );
+
+    /**
+     * Ensure that the buffer contains at least newSize elements.
+     *
+     * Existing data is retained. The size is increased, if necessary.
+     * @version 1.11
+     */
+    void grow( const uint64_t newSize )
+        { if( newSize > _size ) resize( newSize ); }
+
+    /**
+     * Ensure that the buffer contains at least newSize elements.
+     *
+     * Existing data is preserved.
+     * @return the new pointer to the first element.
+     * @version 1.11
+     */
+    T* reserve( const uint64_t newSize );
+
+    /**
+     * Set the buffer size and allocate enough memory.
+     *
+     * Existing data may be deleted.
+     * @return the new pointer to the first element.
+     * @version 1.11
+     */
+    T* reset( const uint64_t newSize )
+        { reserve( newSize ); setSize( newSize ); return _data; }
+
+    /** Set the buffer content to 0. @version 1.11 */
+    void setZero() { ::lunchbox::setZero( _data, _size * sizeof( T )); }
+
+    /** Append elements to the buffer, increasing the size. @version 1.11 */
+    void append( const T* data, const uint64_t size );
+
+    /** Append one element to the buffer. @version 1.11 */
+    void append( const T& element );
+
+    /** Replace the existing data with new data. @version 1.11 */
+    void replace( const void* data, const uint64_t size );
+
+    /** Replace the existing data. @version 1.11 */
+    void replace( const SmallBuffer& from )
+        { replace( from._data, from._size ); }
+
+    /** Swap the buffer contents with another buffer. @version 1.11 */
+    void swap( SmallBuffer& buffer );
+
+    /** @return a pointer to the data. @version 1.11 */
+    T* getData() { return _data; }
+
+    /** @return a const pointer to the data. @version 1.11 */
+    const T* getData() const { return _data; }
+
+    /**
+     * Set the size of the buffer without changing its allocation.
+     *
+     * If the current allocation of the buffer is too small, it asserts,
+     * returns false and does not change the size.
+     * @version 1.11
+     */
+    bool setSize( const uint64_t size );
+
+    /** @return the current number of elements. @version 1.11 */
+    uint64_t getSize() const { return _size; }
+
+    /** @return the current storage size. @version 1.11 */
+    uint64_t getNumBytes() const { return _size * sizeof( T ); }
+
+    /** @return true if the buffer is empty, false if not. @version 1.11 */
+    bool isEmpty() const { return (_size==0); }
+
+    /** @return the maximum size of the buffer. @version 1.11 */
+    uint64_t getMaxSize() const { return _maxSize; }
+
+    /** @return true if the data is in the inline storage. @version 1.11 */
+    bool isInline() const { return _data == _getInline(); }
+
+private:
+    /** A pointer to the data, the inline storage or a heap allocation. */
+    T* _data;
+
+    /** The number of valid items in _data. */
+    uint64_t _size;
+
+    /** The allocation size of the buffer. */
+    uint64_t _maxSize;
+
+    /** The inline storage for N elements. */
+    typename boost::aligned_storage< N * sizeof( T ),
+                                     boost::alignment_of< T >::value >::type
+        _storage;
+
+    T* _getInline() { return reinterpret_cast< T* >( &_storage ); }
+    const T* _getInline() const
+        { return reinterpret_cast< const T* >( &_storage ); }
+
+    void _setAllocation( uint64_t maxSize );
+    void _take( SmallBuffer& from );
+};
+}
+
+#include "smallBuffer.ipp" // template implementation
+
+#endif //LUNCHBOX_SMALLBUFFER_H
@@ -0,0 +1,183 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+namespace lunchbox
+{
+template< class T, size_t N, class A >
+SmallBuffer< T, N, A >::SmallBuffer( SmallBuffer< T, N, A >& from )
+    : _data( _getInline( ))
+    , _size( 0 )
+    , _maxSize( N )
+{
+    _take( from );
+}
+
+template< class T, size_t N, class A > void SmallBuffer< T, N, A >::clear()
+{
+    if( !isInline( ))
+        A::deallocate( _data, _maxSize * sizeof( T ));
+    _data = _getInline();
+    _size = 0;
+    _maxSize = N;
+}
+
+template< class T, size_t N, class A > T* SmallBuffer< T, N, A >::pack()
+{
+    if( _maxSize != _size && !isInline( ))
+        _setAllocation( _size );
+    return _data;
+}
+
+template< class T, size_t N, class A > SmallBuffer< T, N, A >&
+SmallBuffer< T, N, A >::operator = ( const SmallBuffer< T, N, A >& from )
+{
+    if( this != &from )
+        replace( from );
+    return *this;
+}
+
+template< class T, size_t N, class A >
+T* SmallBuffer< T, N, A >::resize( const uint64_t newSize )
+{
+    if( newSize > _maxSize )
+        _setAllocation( newSize + (newSize >> 3) ); // avoid excessive reallocs
+    _size = newSize;
+    return _data;
+}
+
+template< class T, size_t N, class A >
+T* SmallBuffer< T, N, A >::reserve( const uint64_t newSize )
+{
+    if( newSize > _maxSize )
+        _setAllocation( newSize );
+    return _data;
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::append( const T* data, const uint64_t size )
+{
+    LBASSERT( data );
+    LBASSERT( size );
+
+    const uint64_t oldSize = _size;
+    resize( oldSize + size );
+    memcpy( _data + oldSize, data, size * sizeof( T ));
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::append( const T& element )
+{
+    resize( _size + 1 );
+    _data[ _size - 1 ] = element;
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::replace( const void* data, const uint64_t size )
+{
+    LBASSERT( data );
+    LBASSERT( size );
+
+    reserve( size );
+    memcpy( _data, data, size * sizeof( T ));
+    _size = size;
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::swap( SmallBuffer< T, N, A >& buffer )
+{
+    if( isInline() || buffer.isInline( ))
+    {
+        SmallBuffer tmp( *this );
+        _take( buffer );
+        buffer._take( tmp );
+        return;
+    }
+
+    T*             tmpData    = buffer._data;
+    const uint64_t tmpSize    = buffer._size;
+    const uint64_t tmpMaxSize = buffer._maxSize;
+
+    buffer._data = _data;
+    buffer._size = _size;
+    buffer._maxSize = _maxSize;
+
+    _data     = tmpData;
+    _size     = tmpSize;
+    _maxSize = tmpMaxSize;
+}
+
+template< class T, size_t N, class A >
+bool SmallBuffer< T, N, A >::setSize( const uint64_t size )
+{
+    LBASSERT( size <= _maxSize );
+    if( size > _maxSize )
+        return false;
+
+    _size = size;
+    return true;
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::_setAllocation( const uint64_t maxSize )
+{
+    T* const inlineData = _getInline();
+    if( maxSize <= N ) // move heap data back inline
+    {
+        if( _data != inlineData )
+        {
+            memcpy( inlineData, _data, maxSize * sizeof( T ));
+            A::deallocate( _data, _maxSize * sizeof( T ));
+            _data = inlineData;
+        }
+        _maxSize = N;
+        return;
+    }
+
+    T* data = 0;
+    if( _data == inlineData ) // spill to the heap
+    {
+        data = static_cast< T* >( A::allocate( maxSize * sizeof( T )));
+        if( data )
+            memcpy( data, inlineData, N * sizeof( T ));
+    }
+    else
+        data = static_cast< T* >( A::reallocate( _data, _maxSize * sizeof( T ),
+                                                 maxSize * sizeof( T )));
+    if( !data )
+        throw std::bad_alloc(); // _data is still valid
+    _data = data;
+    _maxSize = maxSize;
+}
+
+template< class T, size_t N, class A >
+void SmallBuffer< T, N, A >::_take( SmallBuffer< T, N, A >& from )
+{
+    LBASSERT( isInline( ));
+    if( from.isInline( ))
+        memcpy( _getInline(), from._data, from._size * sizeof( T ));
+    else
+    {
+        _data = from._data;
+        _maxSize = from._maxSize;
+    }
+    _size = from._size;
+
+    from._data = from._getInline();
+    from._size = 0;
+    from._maxSize = N;
+}
+}
@@ -0,0 +1,177 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SNAPSHOT_H
+#define LUNCHBOX_SNAPSHOT_H
+
+#include <lunchbox/atomic.h>         // used inline
+#include <lunchbox/debug.h>          // used inline
+#include <lunchbox/epochReclaimer.h> // member
+#include <lunchbox/refPtr.h>         // used inline
+#include <lunchbox/scopedMutex.h>    // used inline
+#include <lunchbox/spinLock.h>       // member
+
+#include <boost/noncopyable.hpp>
+
+namespace lunchbox
+{
+/**
+ * A read-copy-update container for read-mostly, reference-counted data.
+ *
+ * Holds the current version of an immutable object derived from Referenced.
+ * Readers access the current version without locking, writers publish a new
+ * version atomically. Readers which started before a publish continue to see
+ * the old version. Old versions are released by later publishes or flush()
+ * once no reader uses them anymore, and at the latest with the snapshot.
+ *
+ * A Reader accesses the current version without writing to memory shared
+ * with other threads, and should be used for short, frequent reads. It only
+ * announces its epoch in a per-thread slot of an EpochReclaimer. get() returns
+ * a RefPtr which keeps the version alive independently of this snapshot, at
+ * the cost of one reference count increment and decrement.
+ *
+ * Writers are serialized. update() copies the current version, modifies the
+ * copy and publishes it.
+ *
+ * Example: @include tests/snapshot.cpp
+ */
+template< class T > class Snapshot : public boost::noncopyable
+{
+public:
+    /** Scoped lock-free read access to the current version. @version 1.11 */
+    class Reader : public boost::noncopyable
+    {
+    public:
+        /** Access the current version of the given snapshot. @version 1.11 */
+        explicit Reader( const Snapshot& snapshot )
+            : _guard( snapshot._reclaimer )
+            , _value( snapshot._load( ))
+        {}
+
+        /**
+         * @return the version, valid during the lifetime of this reader.
+         * @version 1.11
+         */
+        const T* get() const { return _value; }
+
+        /** Access the version. @version 1.11 */
+        const T* operator->() const { LBASSERT( _value ); return _value; }
+
+        /** Access the version. @version 1.11 */
+        const T& operator*() const { LBASSERT( _value ); return *_value; }
+
+        /** @return true if a version is published. @version 1.11 */
+        bool isValid() const { return _value != 0; }
+
+    private:
+        const EpochReclaimer::Guard _guard;
+        const T* const _value;
+    };
+
+    /** Construct a new, empty snapshot. @version 1.11 */
+    Snapshot() : _value( 0 ) {}
+
+    /** Construct a new snapshot with an initial version. @version 1.11 */
+    explicit Snapshot( RefPtr< T > value ) : _value( value.get( ))
+    {
+        if( _value )
+            _value->ref();
+    }
+
+    /** Destruct the snapshot, releasing the current version. @version 1.11 */
+    ~Snapshot()
+    {
+        if( _value )
+            _value->unref();
+    }
+
+    /** @return a reference to the current version. @version 1.11 */
+    RefPtr< const T > get() const
+    {
+        const EpochReclaimer::Guard guard( _reclaimer );
+        return RefPtr< const T >( _load( ));
+    }
+
+    /**
+     * Publish a new version.
+     *
+     * The value must not be modified after publishing.
+     * @version 1.11
+     */
+    void set( RefPtr< T > value )
+    {
+        ScopedFastWrite mutex( _writeLock );
+        _publish( value.get( ));
+    }
+
+    /**
+     * Publish a modified copy of the current version.
+     *
+     * The functor is called as func( T& ) with a copy of the current version,
+     * or a default-constructed object if no version is published. Concurrent
+     * updates are serialized and do not lose modifications.
+     * @version 1.11
+     */
+    template< class F > void update( F func )
+    {
+        ScopedFastWrite mutex( _writeLock );
+        const T* current = _load();
+        RefPtr< T > value = current ? new T( *current ) : new T;
+        func( *value );
+        _publish( value.get( ));
+    }
+
+    /**
+     * Release the old versions no longer used by any reader.
+     *
+     * @return true if no old version remains.
+     * @version 1.11
+     */
+    bool flush() { return _reclaimer.flush(); }
+
+private:
+    const T* _value; // holds one reference
+    EpochReclaimer _reclaimer;
+    SpinLock _writeLock;
+
+    /** Retired version, unreferenced after the last reader has left. */
+    struct Release
+    {
+        explicit Release( const T* value_ ) : value( value_ ) {}
+        ~Release() { value->unref(); }
+        const T* const value;
+    };
+
+    const T* _load() const
+        { return *static_cast< const T* const volatile* >( &_value ); }
+
+    void _publish( const T* value )
+    {
+        if( value )
+            value->ref();
+
+        const T* old = _value;
+        while( !Atomic< const T* >::compareAndSwap( &_value, old, value ))
+            old = _value;
+
+        if( old )
+            _reclaimer.retire( new Release( old ));
+    }
+};
+}
+
+#endif // LUNCHBOX_SNAPSHOT_H
@@ -17,6 +17,7 @@
 
 #include "spinLock.h"
 #include <lunchbox/atomic.h>
+#include <lunchbox/spinWait.h>
 #include <lunchbox/thread.h>
 
 namespace lunchbox
@@ -36,11 +37,12 @@ public:
 
     inline void set()
         {
+            SpinWait spin;
             while( true )
             {
                 if( trySet( ))
                     return;
-                lunchbox::Thread::yield();
+                spin.spinOnce();
             }
         }
 
@@ -60,11 +62,12 @@ public:
 
     inline void setRead()
         {
+            SpinWait spin;
             while( true )
             {
                 if( trySetRead( ))
                     return;
-                lunchbox::Thread::yield();
+                spin.spinOnce();
             }
         }
 
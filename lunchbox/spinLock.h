@@ -28,8 +28,9 @@ namespace detail { class SpinLock; }
 /**
  * A fast lock for uncontended memory access.
  *
- * If Thread::yield() does not work, priority inversion is possible. If used as
- * a read-write lock, readers or writers will starve on high contention.
+ * Contended threads back off using a SpinWait. If Thread::yield() does not
+ * work, priority inversion is possible. If used as a read-write lock, readers
+ * or writers will starve on high contention.
  *
  * @sa ScopedMutex
  *
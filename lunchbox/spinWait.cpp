@@ -0,0 +1,74 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "spinWait.h"
+#include "atomic.h"
+#include "detail/cores.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || \
+    defined(_M_X64)
+#  include <emmintrin.h> // _mm_pause
+#  define LB_PAUSE() _mm_pause()
+#else
+#  define LB_PAUSE()
+#endif
+
+namespace lunchbox
+{
+namespace
+{
+static const uint32_t _yieldSteps = 10; // ~300 PAUSE instructions
+static const uint32_t _parkSteps = 20;  // then ten yields
+
+// Function-local statics, usable by SpinWaits during static initialization
+a_int32_t& _defaultYieldThreshold()
+{
+    static a_int32_t threshold( detail::getNCores() > 1 ? _yieldSteps : 0 );
+    return threshold;
+}
+
+a_int32_t& _defaultParkThreshold()
+{
+    static a_int32_t threshold( _parkSteps );
+    return threshold;
+}
+}
+
+void SpinWait::pause( const uint32_t count )
+{
+    for( uint32_t i = 0; i < count; ++i )
+        LB_PAUSE();
+}
+
+void SpinWait::setDefaults( const uint32_t yieldThreshold,
+                            const uint32_t parkThreshold )
+{
+    _defaultYieldThreshold() = int32_t( yieldThreshold );
+    _defaultParkThreshold() = int32_t( parkThreshold );
+}
+
+uint32_t SpinWait::getDefaultYieldThreshold()
+{
+    return uint32_t( int32_t( _defaultYieldThreshold( )));
+}
+
+uint32_t SpinWait::getDefaultParkThreshold()
+{
+    return uint32_t( int32_t( _defaultParkThreshold( )));
+}
+
+}
@@ -0,0 +1,135 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_SPINWAIT_H
+#define LUNCHBOX_SPINWAIT_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/thread.h> // used in inline method
+#include <lunchbox/types.h>
+
+#include <algorithm> // std::min
+
+namespace lunchbox
+{
+/**
+ * A backoff policy for threads waiting on a condition by polling.
+ *
+ * Each call to spinOnce() is one step of the policy. Up to the yield
+ * threshold, the thread busy-waits with an exponentially growing number of
+ * PAUSE instructions. Up to the park threshold, it yields its time slice.
+ * Afterwards, shouldPark() is true and callers with a blocking fallback
+ * should block, while other callers continue to yield.
+ *
+ * The default thresholds are set globally, and each call site may use its
+ * own. On single-core machines, the default yield threshold is zero, since
+ * busy-waiting only delays the thread it waits for.
+ *
+ * Example:
+ * @code
+ * SpinWait spin;
+ * while( !condition( ))
+ * {
+ *     if( spin.shouldPark( ))
+ *         return block();
+ *     spin.spinOnce();
+ * }
+ * @endcode
+ */
+class SpinWait
+{
+public:
+    /** Construct a new policy with the global defaults. @version 1.11 */
+    SpinWait()
+        : _yieldThreshold( getDefaultYieldThreshold( ))
+        , _parkThreshold( getDefaultParkThreshold( ))
+        , _count( 0 )
+    {}
+
+    /**
+     * Construct a new policy with the given thresholds.
+     *
+     * @param yieldThreshold the number of busy-waiting steps.
+     * @param parkThreshold the number of steps until shouldPark() is true.
+     * @version 1.11
+     */
+    SpinWait( const uint32_t yieldThreshold, const uint32_t parkThreshold )
+        : _yieldThreshold( yieldThreshold )
+        , _parkThreshold( parkThreshold )
+        , _count( 0 )
+    {}
+
+    /** Perform one backoff step. @version 1.11 */
+    void spinOnce()
+    {
+        if( _count < _yieldThreshold )
+        {
+            const uint32_t shift = std::min( _count, uint32_t( _maxShift ));
+            pause( 1u << shift );
+        }
+        else
+            Thread::yield();
+
+        if( _count < _parkThreshold )
+            ++_count;
+    }
+
+    /** @return true if the caller should block. @version 1.11 */
+    bool shouldPark() const { return _count >= _parkThreshold; }
+
+    /** @return true if the next step yields. @version 1.11 */
+    bool willYield() const { return _count >= _yieldThreshold; }
+
+    /** Restart the policy, e.g., after progress was made. @version 1.11 */
+    void reset() { _count = 0; }
+
+    /** @return the number of steps performed. @version 1.11 */
+    uint32_t getCount() const { return _count; }
+
+    /**
+     * Execute the processor's spin-wait hint, e.g., PAUSE on x86.
+     *
+     * @param count the number of hints to execute.
+     * @version 1.11
+     */
+    static LUNCHBOX_API void pause( uint32_t count = 1 );
+
+    /**
+     * Set the global default thresholds.
+     *
+     * Affects policies constructed afterwards. Thread-safe.
+     * @version 1.11
+     */
+    static LUNCHBOX_API void setDefaults( uint32_t yieldThreshold,
+                                          uint32_t parkThreshold );
+
+    /** @return the global default busy-waiting steps. @version 1.11 */
+    static LUNCHBOX_API uint32_t getDefaultYieldThreshold();
+
+    /** @return the global default steps before parking. @version 1.11 */
+    static LUNCHBOX_API uint32_t getDefaultParkThreshold();
+
+private:
+    enum { _maxShift = 6 }; // at most 64 PAUSE instructions per step
+
+    uint32_t _yieldThreshold;
+    uint32_t _parkThreshold;
+    uint32_t _count;
+};
+}
+
+#endif // LUNCHBOX_SPINWAIT_H
@@ -44,11 +44,15 @@
 #ifdef __linux__
 #  include <sys/prctl.h>
 #endif
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
 
 #ifdef LUNCHBOX_USE_HWLOC
 #  include <hwloc.h>
 #endif
 
+#include "detail/cores.h"
 #include "detail/threadID.h"
 
 namespace lunchbox
@@ -289,6 +293,18 @@ void Thread::pinCurrentThread()
 #endif
 }
 
+size_t detail::getNCores()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return info.dwNumberOfProcessors;
+#else
+    const long nCores = ::sysconf( _SC_NPROCESSORS_ONLN );
+    return nCores > 0 ? size_t( nCores ) : 1;
+#endif
+}
+
 #ifdef _MSC_VER
 #  ifndef MS_VC_EXCEPTION
 #    define MS_VC_EXCEPTION 0x406D1388
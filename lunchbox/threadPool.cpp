@@ -0,0 +1,172 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "threadPool.h"
+
+#include "atomic.h"
+#include "debug.h"
+#include "lock.h"
+#include "mtQueue.h"
+#include "scopedMutex.h"
+#include "thread.h"
+
+#include "detail/cores.h"
+
+#include <vector>
+
+namespace lunchbox
+{
+namespace
+{
+typedef MTQueue< Executor::Task > TaskQueue;
+
+class Worker : public Thread
+{
+public:
+    explicit Worker( TaskQueue& tasks ) : _tasks( tasks ) {}
+
+protected:
+    virtual bool init()
+    {
+        setName( "PoolWorker" );
+        return true;
+    }
+
+    virtual void run()
+    {
+        for( ;; )
+        {
+            const Executor::Task task = _tasks.pop();
+            if( task.empty( )) // stops the worker
+                return;
+            task();
+        }
+    }
+
+private:
+    TaskQueue& _tasks;
+};
+}
+
+namespace detail
+{
+class ThreadPool
+{
+public:
+    ThreadPool( const size_t size, const size_t maxQueueDepth )
+        : tasks( maxQueueDepth > 0 ? maxQueueDepth : LB_UNDEFINED_UINT32 )
+    {
+        const size_t nThreads = size > 0 ? size : detail::getNCores();
+        for( size_t i = 0; i < nThreads; ++i )
+        {
+            Worker* worker = new Worker( tasks );
+            if( !worker->start( ))
+            {
+                LBWARN << "Could not start thread pool worker" << std::endl;
+                delete worker;
+                break;
+            }
+            workers.push_back( worker );
+        }
+        LBASSERT( !workers.empty( ));
+    }
+
+    ~ThreadPool()
+    {
+        // queued behind all pending tasks, one per worker
+        for( size_t i = 0; i < workers.size(); ++i )
+            tasks.push( Executor::Task( ));
+        for( size_t i = 0; i < workers.size(); ++i )
+        {
+            workers[ i ]->join();
+            delete workers[ i ];
+        }
+    }
+
+    TaskQueue tasks;
+    std::vector< Worker* > workers;
+};
+}
+
+ThreadPool::ThreadPool( const size_t size, const size_t maxQueueDepth )
+    : _impl( new detail::ThreadPool( size, maxQueueDepth ))
+{}
+
+ThreadPool::~ThreadPool()
+{
+    delete _impl;
+}
+
+void ThreadPool::post( const Task& task )
+{
+    LBASSERT( !task.empty( ));
+    _impl->tasks.push( task );
+}
+
+bool ThreadPool::tryPost( const Task& task )
+{
+    LBASSERT( !task.empty( ));
+    return _impl->tasks.tryPush( task );
+}
+
+size_t ThreadPool::getSize() const
+{
+    return _impl->workers.size();
+}
+
+size_t ThreadPool::getQueueDepth() const
+{
+    return _impl->tasks.getSize();
+}
+
+namespace
+{
+// Leaked to stay usable during static destruction, see shutdownDefault()
+ThreadPool* _default = 0;
+
+Lock& _getDefaultLock()
+{
+    static Lock* lock = new Lock;
+    return *lock;
+}
+}
+
+ThreadPool& ThreadPool::getDefault()
+{
+    ThreadPool* pool = _default;
+    memoryBarrierAcquire();
+    if( pool )
+        return *pool;
+
+    ScopedWrite mutex( _getDefaultLock( ));
+    if( !_default )
+    {
+        pool = new ThreadPool;
+        memoryBarrierRelease();
+        _default = pool;
+    }
+    return *_default;
+}
+
+void ThreadPool::shutdownDefault()
+{
+    ScopedWrite mutex( _getDefaultLock( ));
+    delete _default;
+    _default = 0;
+}
+
+}
@@ -0,0 +1,94 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LUNCHBOX_THREADPOOL_H
+#define LUNCHBOX_THREADPOOL_H
+
+#include <lunchbox/api.h>
+#include <lunchbox/executor.h> // base class
+#include <lunchbox/types.h>
+
+namespace lunchbox
+{
+namespace detail { class ThreadPool; }
+
+/**
+ * An Executor running tasks on a fixed set of worker threads.
+ *
+ * Tasks are queued in FIFO order and run by the first idle worker. The queue
+ * may be bounded, in which case post() blocks and tryPost() fails while the
+ * queue is full, which throttles producers outpacing the workers.
+ *
+ * Example: @include tests/threadPool.cpp
+ */
+class ThreadPool : public Executor
+{
+public:
+    /**
+     * Construct a new thread pool and start its workers.
+     *
+     * @param size the number of worker threads, 0 for one per core.
+     * @param maxQueueDepth the maximum number of queued tasks, 0 for an
+     *                      unbounded queue.
+     * @version 1.11
+     */
+    LUNCHBOX_API explicit ThreadPool( size_t size = 0,
+                                      size_t maxQueueDepth = 0 );
+
+    /** Run all queued tasks and stop the workers. @version 1.11 */
+    LUNCHBOX_API ~ThreadPool();
+
+    /** Queue a task, blocking while the queue is full. @version 1.11 */
+    LUNCHBOX_API void post( const Task& task ) final;
+
+    /**
+     * Queue a task if the queue is not full.
+     *
+     * @return true if the task was queued, false if the queue is full.
+     * @version 1.11
+     */
+    LUNCHBOX_API bool tryPost( const Task& task );
+
+    /** @return the number of worker threads. @version 1.11 */
+    LUNCHBOX_API size_t getSize() const;
+
+    /** @return the number of tasks waiting for a worker. @version 1.11 */
+    LUNCHBOX_API size_t getQueueDepth() const;
+
+    /**
+     * @return the process-wide pool used by async(), created on first use
+     *         with one worker per core and an unbounded queue.
+     * @version 1.11
+     */
+    LUNCHBOX_API static ThreadPool& getDefault();
+
+    /**
+     * Finish the queued tasks and stop the workers of the default pool.
+     *
+     * The default pool is never destroyed automatically. A later
+     * getDefault() creates a new pool. Must not be called while other
+     * threads use the default pool.
+     * @version 1.11
+     */
+    LUNCHBOX_API static void shutdownDefault();
+
+private:
+    detail::ThreadPool* const _impl;
+};
+}
+
+#endif // LUNCHBOX_THREADPOOL_H
@@ -218,6 +218,7 @@ typedef Strings::iterator StringsIter;
 
 class Clock;
 class DSO;
+class Executor;
 class Lock;
 class NonCopyable;
 class Referenced;
@@ -226,13 +227,15 @@ class Servus;
 class SpinLock;
 class URI;
 class uint128_t;
+struct MallocAllocator;
 
 template< class > class Array;
 template< class > class Atomic;
-template< class > class Buffer;
 template< class > class Future;
 template< class > class Monitor;
+template< class > class Promise;
 template< class > class Request;
+template< class T, class A = MallocAllocator > class Buffer;
 template< class, class > class LFVectorIterator;
 template< class, class > class Lockable;
 template< class, class > class Plugin;
@@ -0,0 +1,130 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/arena.h>
+#include <lunchbox/buffer.h>
+#include <lunchbox/perThread.h>
+#include <lunchbox/thread.h>
+
+#include <vector>
+
+#define NTHREADS 4
+
+lunchbox::PerThread< lunchbox::Arena > arenas_;
+
+lunchbox::Arena& getThreadArena()
+{
+    if( !arenas_ )
+        arenas_ = new lunchbox::Arena;
+    return *arenas_;
+}
+
+typedef lunchbox::ArenaBufferAllocator< &getThreadArena > BufferAllocator;
+typedef lunchbox::Buffer< uint32_t, BufferAllocator > Buffer;
+typedef std::vector< uint32_t, lunchbox::ArenaAllocator< uint32_t > > Vector;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        lunchbox::Arena& arena = getThreadArena();
+        for( size_t frame = 0; frame < 100; ++frame )
+        {
+            TEST( arena.allocate( 100 ));
+            const size_t used = arena.getUsedSize();
+            {
+                // grows in place as the most recent allocation
+                Buffer buffer;
+                for( uint32_t i = 0; i < 1000; ++i )
+                    buffer.append( i );
+                TEST( buffer[ 999 ] == 999 );
+                TEST( arena.getUsedSize() >= used + 4000 );
+            }
+            TEST( arena.getUsedSize() == used );
+            arena.reset();
+        }
+        TEST( &getThreadArena() == &arena );
+    }
+};
+
+int main( int, char** )
+{
+    lunchbox::Arena arena( 1024 );
+    TEST( arena.allocate( 0 ) == 0 );
+    TEST( arena.getAllocatedSize() == 0 );
+
+    void* first = arena.allocate( 10 );
+    void* second = arena.allocate( 10 );
+    TEST( first && second );
+    TEST(( size_t( first ) & 15 ) == 0 );
+    TEST(( size_t( second ) & 15 ) == 0 );
+    TEST( static_cast< uint8_t* >( second ) ==
+          static_cast< uint8_t* >( first ) + 16 );
+    TEST( arena.getAllocatedSize() == 1024 );
+
+    // the most recent allocation is resized and released in place
+    TEST( arena.reallocate( second, 10, 100 ) == second );
+    TEST( arena.reallocate( first, 10, 20 ) != first );
+    const size_t used = arena.getUsedSize();
+    void* third = arena.allocate( 100 );
+    arena.deallocate( third, 100 );
+    TEST( arena.getUsedSize() == used );
+
+    // large allocations get their own block
+    void* large = arena.allocate( 4096 );
+    TEST( large );
+    TEST( arena.getAllocatedSize() >= 1024 + 4096 );
+
+    {
+        const lunchbox::Arena::Scope scope( arena );
+        for( size_t i = 0; i < 100; ++i )
+            arena.allocate( 100 );
+        TEST( arena.getUsedSize() > used + 10000 );
+    }
+    TEST( arena.getUsedSize() >= used + 4096 );
+    TEST( arena.getUsedSize() < used + 8192 );
+
+    // reset keeps the blocks
+    const size_t allocated = arena.getAllocatedSize();
+    arena.reset();
+    TEST( arena.getUsedSize() == 0 );
+    TEST( arena.allocate( 10 ) == first );
+    for( size_t i = 0; i < 100; ++i )
+        arena.allocate( 100 );
+    TEST( arena.getAllocatedSize() == allocated );
+    arena.reset();
+
+    {
+        Vector vector( ( lunchbox::ArenaAllocator< uint32_t >( arena )));
+        for( uint32_t i = 0; i < 1000; ++i )
+            vector.push_back( i );
+        TEST( vector[ 999 ] == 999 );
+        TEST( arena.getUsedSize() >= 4000 );
+    }
+
+    arena.clear();
+    TEST( arena.getAllocatedSize() == 0 );
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].start( ));
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/barrier.h>
+#include <lunchbox/thread.h>
+
+#include <boost/bind.hpp>
+
+#define MAXTHREADS 17
+#define NPHASES 1000
+
+lunchbox::a_int32_t _arrived;
+lunchbox::a_int32_t _nSerial;
+size_t _nCompleted = 0;
+
+void complete() { ++_nCompleted; }
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : barrier( 0 ), index( 0 ) {}
+
+    virtual void run()
+    {
+        for( size_t i = 0; i < NPHASES; ++i )
+        {
+            ++_arrived;
+            if( barrier->enter( index ))
+                ++_nSerial;
+
+            // all threads arrived, none can arrive again before the next phase
+            const int32_t arrived = _arrived;
+            TESTINFO( arrived == int32_t( (i + 1) * barrier->getSize( )),
+                      arrived << " in phase " << i );
+            barrier->enter( index );
+        }
+    }
+
+    lunchbox::Barrier* barrier;
+    size_t index;
+};
+
+void testBarrier( const size_t nThreads, const lunchbox::Barrier::Mode mode )
+{
+    lunchbox::Barrier barrier( nThreads, mode, boost::bind( &complete ));
+    TEST( barrier.getSize() == nThreads );
+    TEST( barrier.getPhase() == 0 );
+
+    _arrived = 0;
+    _nSerial = 0;
+    _nCompleted = 0;
+
+    Thread threads[ MAXTHREADS ];
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        threads[ i ].barrier = &barrier;
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < nThreads; ++i )
+        TEST( threads[ i ].join( ));
+
+    TEST( _arrived == int32_t( nThreads * NPHASES ));
+    TEST( _nSerial == NPHASES );
+    TESTINFO( _nCompleted == 2 * NPHASES, _nCompleted );
+    TEST( barrier.getPhase() == 2 * NPHASES );
+}
+
+int main( int, char** )
+{
+    lunchbox::Barrier single( 1 );
+    TEST( single.enter( ));
+    TEST( single.enter( ));
+    TEST( single.getPhase() == 2 );
+
+    const size_t sizes[] = { 1, 2, 3, 4, 5, 16, MAXTHREADS };
+    for( size_t i = 0; i < sizeof( sizes ) / sizeof( size_t ); ++i )
+    {
+        testBarrier( sizes[ i ], lunchbox::Barrier::CENTRAL );
+        testBarrier( sizes[ i ], lunchbox::Barrier::TREE );
+    }
+    return EXIT_SUCCESS;
+}
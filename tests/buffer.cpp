@@ -0,0 +1,143 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/buffer.h>
+
+#define LARGE (4 * LB_1MB)
+
+template< class B > void testBuffer()
+{
+    B buffer;
+    TEST( buffer.isEmpty( ));
+    TEST( buffer.getData() == 0 );
+
+    for( uint32_t i = 0; i < 1000; ++i )
+        buffer.append( i );
+    TEST( buffer.getSize() == 1000 );
+    TEST( buffer.getMaxSize() >= 1000 );
+    for( uint32_t i = 0; i < 1000; ++i )
+        TEST( buffer[ i ] == i );
+
+    buffer.pack();
+    TEST( buffer.getMaxSize() == 1000 );
+    TEST( buffer[ 999 ] == 999 );
+
+    // grow beyond the huge page size and remap threshold
+    buffer.resize( LARGE );
+    TEST( buffer.getSize() == LARGE );
+    for( uint32_t i = 0; i < 1000; ++i )
+        TEST( buffer[ i ] == i );
+    buffer[ LARGE - 1 ] = 42;
+
+    B copy;
+    copy = buffer;
+    TEST( copy.getSize() == LARGE );
+    TEST( copy[ 999 ] == 999 );
+    TEST( copy[ LARGE - 1 ] == 42 );
+
+    buffer.setSize( 10 );
+    buffer.pack();
+    TEST( buffer.getMaxSize() == 10 );
+    TEST( buffer[ 9 ] == 9 );
+
+    B moved( copy );
+    TEST( copy.isEmpty( ));
+    TEST( moved.getSize() == LARGE );
+    moved.swap( buffer );
+    TEST( buffer.getSize() == LARGE );
+    TEST( moved.getSize() == 10 );
+
+    buffer.clear();
+    TEST( buffer.getData() == 0 );
+    TEST( buffer.getMaxSize() == 0 );
+}
+
+template< class A > void testAlignment()
+{
+    lunchbox::Buffer< uint8_t, A > buffer;
+    for( size_t i = 1; i < 200; i += 7 )
+    {
+        buffer.reset( i );
+        TEST( ( size_t( buffer.getData( )) & 63 ) == 0 );
+    }
+}
+
+// Allocation policy which fails on demand
+struct FailingAllocator : public lunchbox::MallocAllocator
+{
+    static bool fail;
+    static void* allocate( const size_t size )
+        { return fail ? 0 : MallocAllocator::allocate( size ); }
+    static void* reallocate( void* ptr, const size_t oldSize,
+                             const size_t newSize )
+    {
+        return fail ? 0 : MallocAllocator::reallocate( ptr, oldSize,
+                                                       newSize );
+    }
+};
+bool FailingAllocator::fail = false;
+
+void testFailure()
+{
+    lunchbox::Buffer< uint32_t, FailingAllocator > buffer;
+    buffer.append( 42 );
+    const uint64_t maxSize = buffer.getMaxSize();
+
+    FailingAllocator::fail = true;
+    bool thrown = false;
+    try
+    {
+        buffer.reserve( LARGE );
+    }
+    catch( const std::bad_alloc& )
+    {
+        thrown = true;
+    }
+    FailingAllocator::fail = false;
+
+    TEST( thrown );
+    TEST( buffer.getSize() == 1 );
+    TEST( buffer.getMaxSize() == maxSize );
+    TEST( buffer[ 0 ] == 42 );
+}
+
+int main( int, char** )
+{
+    testBuffer< lunchbox::Buffer< uint32_t > >();
+    testBuffer< lunchbox::Buffer< uint32_t, lunchbox::AlignedAllocator<> > >();
+    testBuffer< lunchbox::Buffer< uint32_t, lunchbox::HugePageAllocator > >();
+    testBuffer< lunchbox::Buffer< uint32_t, lunchbox::MMapAllocator > >();
+    testBuffer< lunchbox::Buffer< uint32_t, lunchbox::PoolAllocator > >();
+
+    testAlignment< lunchbox::AlignedAllocator<> >();
+    testAlignment< lunchbox::MMapAllocator >();
+    testFailure();
+
+    // released blocks are reused
+    void* block = lunchbox::PoolAllocator::allocate( 100 );
+    lunchbox::PoolAllocator::deallocate( block, 100 );
+    TEST( lunchbox::PoolAllocator::allocate( 128 ) == block );
+    TEST( lunchbox::PoolAllocator::reallocate( block, 128, 70 ) == block );
+    lunchbox::PoolAllocator::deallocate( block, 70 );
+    lunchbox::PoolAllocator::flush();
+
+    lunchbox::Bufferb bytes;
+    bytes.append( 42 );
+    TEST( bytes.getSize() == 1 );
+    return EXIT_SUCCESS;
+}
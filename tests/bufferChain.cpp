@@ -0,0 +1,93 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/bufferChain.h>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+int main( int, char** )
+{
+    uint8_t header[ 8 ] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    lunchbox::Bufferb payload;
+    for( uint8_t i = 8; i < 100; ++i )
+        payload.append( i );
+    const uint8_t* payloadData = payload.getData();
+
+    lunchbox::Bufferb trailerData;
+    for( uint8_t i = 100; i < 110; ++i )
+        trailerData.append( i );
+    const lunchbox::BufferView trailer( trailerData );
+
+    lunchbox::BufferChain chain;
+    TEST( chain.isEmpty( ));
+    TEST( chain.getIOVecs() == 0 );
+
+    chain.append( header, sizeof( header ));
+    chain.append( payload );
+    chain.append( trailer );
+    chain.append( header, 0 ); // ignored
+    TEST( payload.isEmpty( ));
+    TEST( !trailer.isUnique( ));
+    TEST( chain.getNSegments() == 3 );
+    TEST( chain.getSize() == 110 );
+
+    const lunchbox::iovec* iovecs = chain.getIOVecs();
+    TEST( iovecs[ 0 ].iov_base == header );
+    TEST( iovecs[ 1 ].iov_base == payloadData );
+    TEST( iovecs[ 1 ].iov_len == 92 );
+    TEST( iovecs[ 2 ].iov_base == trailer.getData( ));
+
+    uint8_t data[ 110 ];
+    TEST( chain.copyTo( data ) == 110 );
+    for( uint8_t i = 0; i < 110; ++i )
+        TEST( data[ i ] == i );
+
+#ifndef _WIN32
+    int pipes[ 2 ];
+    TEST( ::pipe( pipes ) == 0 );
+    TEST( ::writev( pipes[ 1 ], iovecs, int( chain.getNSegments( ))) == 110 );
+
+    uint8_t first[ 50 ];
+    uint8_t second[ 60 ];
+    lunchbox::BufferChain input;
+    input.append( first, sizeof( first ));
+    input.append( second, sizeof( second ));
+    TEST( ::readv( pipes[ 0 ], input.getIOVecs(),
+                   int( input.getNSegments( ))) == 110 );
+    TEST( first[ 49 ] == 49 );
+    TEST( second[ 0 ] == 50 );
+    TEST( second[ 59 ] == 109 );
+    ::close( pipes[ 0 ] );
+    ::close( pipes[ 1 ] );
+#endif
+
+    const uint8_t* linear = chain.linearize();
+    TEST( chain.getNSegments() == 1 );
+    TEST( chain.getSize() == 110 );
+    TEST( trailer.isUnique( ));
+    for( uint8_t i = 0; i < 110; ++i )
+        TEST( linear[ i ] == i );
+    TEST( chain.linearize() == linear );
+
+    chain.clear();
+    TEST( chain.isEmpty( ));
+    TEST( chain.linearize() == 0 );
+    return EXIT_SUCCESS;
+}
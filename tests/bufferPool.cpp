@@ -0,0 +1,114 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/bufferPool.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 8
+#define NLOOPS   1000
+
+typedef lunchbox::BufferPoolb Pool;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : pool( 0 ) {}
+
+    virtual void run()
+    {
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            const uint64_t size = 1 + ( i * 4099 ) % LB_1MB;
+            Pool::Buffer* buffer = pool->alloc( size );
+            TEST( buffer->getSize() == size );
+            buffer->getData()[ size - 1 ] = 42;
+            pool->release( buffer );
+        }
+    }
+
+    Pool* pool;
+};
+
+int main( int, char** )
+{
+    Pool pool( 4 * LB_1MB, 1024 );
+    TEST( pool.getClass( 0 ) == 0 );
+    TEST( pool.getClass( 1024 ) == 0 );
+    TEST( pool.getClass( 1025 ) == 1 );
+    TEST( pool.getClass( LB_1MB ) == 10 );
+    TEST( pool.getClassSize( 10 ) == LB_1MB );
+
+    Pool::Buffer* buffer = pool.alloc( 3000 );
+    TEST( buffer->getSize() == 3000 );
+    TEST( buffer->getMaxSize() == 4096 );
+    uint8_t* data = buffer->getData();
+    pool.release( buffer );
+
+    Pool::Stats stats = pool.getStats();
+    TEST( stats.nMisses == 1 );
+    TEST( stats.nCached == 1 );
+    TEST( stats.cachedBytes == 4096 );
+
+    // same size class, same memory
+    buffer = pool.alloc( 2049 );
+    TEST( buffer->getData() == data );
+    TEST( buffer->getSize() == 2049 );
+    stats = pool.getStats();
+    TEST( stats.nHits == 1 );
+    TEST( stats.nCached == 0 );
+    TEST( stats.cachedBytes == 0 );
+
+    // a grown buffer is cached in the largest class it can serve
+    buffer->resize( 10000 );
+    pool.release( buffer );
+    stats = pool.getStats();
+    TEST( stats.cachedBytes == buffer->getMaxSize( ));
+    TEST( pool.alloc( 8192 ) == buffer );
+    pool.release( buffer );
+
+    // the cached capacity is limited
+    Pool::Buffer* large[ 3 ];
+    for( size_t i = 0; i < 3; ++i )
+        large[ i ] = pool.alloc( 2 * LB_1MB );
+    for( size_t i = 0; i < 3; ++i )
+        pool.release( large[ i ] );
+    stats = pool.getStats();
+    TEST( stats.nDropped == 2 );
+    TEST( stats.nCached == 2 );
+
+    pool.trim( 2 * LB_1MB );
+    stats = pool.getStats();
+    TEST( stats.nTrimmed == 1 );
+    TEST( stats.nCached == 1 );
+    TEST( stats.cachedBytes <= 2 * LB_1MB );
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].pool = &pool;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    stats = pool.getStats();
+    TESTINFO( stats.nHits > stats.nMisses,
+              stats.nHits << " hits, " << stats.nMisses << " misses" );
+    TEST( stats.cachedBytes <= 4 * LB_1MB );
+    return EXIT_SUCCESS;
+}
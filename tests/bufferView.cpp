@@ -0,0 +1,65 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/bufferView.h>
+
+int main( int, char** )
+{
+    lunchbox::Bufferb buffer;
+    for( uint8_t i = 0; i < 100; ++i )
+        buffer.append( i );
+    const uint8_t* data = buffer.getData();
+
+    lunchbox::BufferView view( buffer );
+    TEST( buffer.isEmpty( ));
+    TEST( buffer.getData() == 0 );
+    TEST( view.getData() == data );
+    TEST( view.getSize() == 100 );
+    TEST( view.isUnique( ));
+
+    lunchbox::BufferView header = view.getSlice( 0, 10 );
+    lunchbox::BufferView payload = view.getSlice( 10 );
+    TEST( !view.isUnique( ));
+    TEST( header.getData() == data );
+    TEST( header.getSize() == 10 );
+    TEST( header[ 9 ] == 9 );
+    TEST( payload.getData() == data + 10 );
+    TEST( payload.getSize() == 90 );
+    TEST( payload[ 0 ] == 10 );
+
+    // slices of slices, clamped to the parent
+    lunchbox::BufferView tail = payload.getSlice( 80, 100 );
+    TEST( tail.getSize() == 10 );
+    TEST( tail[ 9 ] == 99 );
+    TEST( payload.getSlice( 90 ).isEmpty( ));
+
+    // the storage lives until the last view is gone
+    view.clear();
+    header.clear();
+    payload = lunchbox::BufferView();
+    TEST( tail.isUnique( ));
+    TEST( tail[ 0 ] == 90 );
+
+    lunchbox::BufferView copy( data, 0 );
+    TEST( copy.isEmpty( ));
+    copy = lunchbox::BufferView( tail.getData(), tail.getSize( ));
+    TEST( copy.getData() != tail.getData( ));
+    TEST( copy.getSize() == 10 );
+    TEST( copy[ 9 ] == 99 );
+    return EXIT_SUCCESS;
+}
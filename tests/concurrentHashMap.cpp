@@ -0,0 +1,113 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/concurrentHashMap.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 16
+#define NKEYS    10000
+
+typedef lunchbox::ConcurrentHashMap< uint32_t, uint32_t > Map;
+Map map_( 16 );
+const uint32_t counter_ = LB_UNDEFINED_UINT32;
+
+struct Increment
+{
+    void operator()( uint32_t& value ) const { ++value; }
+};
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : index( 0 ) {}
+
+    virtual void run()
+    {
+        const uint32_t start = index * NKEYS;
+        for( uint32_t i = start; i < start + NKEYS; ++i )
+            TEST( map_.insert( i, i ));
+
+        for( uint32_t i = start; i < start + NKEYS; ++i )
+        {
+            TEST( map_.update( i, Increment( )));
+            TEST( map_.update( counter_, Increment( )));
+        }
+
+        for( uint32_t i = start + 1; i < start + NKEYS; ++i )
+        {
+            uint32_t value = 0;
+            TEST( map_.find( i, value ));
+            TESTINFO( value == i + 1, value << " != " << i + 1 );
+            if( i % 2 )
+                TEST( map_.erase( i ));
+        }
+    }
+
+    uint32_t index;
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    Map map;
+    uint32_t value = 0;
+    TEST( map.empty( ));
+    TEST( map.getNStripes() == 64 );
+    TEST( !map.find( 42, value ));
+    TEST( map.insert( 42, 17 ));
+    TEST( !map.insert( 42, 18 ));
+    TEST( map.find( 42, value ));
+    TEST( value == 17 );
+    TEST( !map.set( 42, 18 ));
+    TEST( map.set( 43, 19 ));
+    TEST( map.contains( 43 ));
+    TEST( map.size() == 2 );
+    TEST( map.update( 42, Increment( )));
+    TEST( !map.update( 44, Increment( )));
+
+    Map::Map copy = map.snapshot();
+    TEST( copy.size() == 2 );
+    TEST( copy[ 42 ] == 19 );
+    TEST( copy[ 43 ] == 19 );
+
+    TEST( map.erase( 42, value ));
+    TEST( value == 19 );
+    TEST( !map.erase( 42 ));
+    map.clear();
+    TEST( map.empty( ));
+
+    TEST( map_.insert( counter_, 0 ));
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    TEST( map_.find( counter_, value ));
+    TESTINFO( value == NTHREADS * NKEYS, value );
+    TESTINFO( map_.size() == NTHREADS * NKEYS / 2 + 1, map_.size( ));
+    TEST( map_.snapshot().size() == map_.size( ));
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
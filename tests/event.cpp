@@ -0,0 +1,104 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/event.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+
+lunchbox::a_int32_t _nReleased;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : event( 0 ) {}
+
+    virtual void run()
+    {
+        TEST( event->wait( ));
+        ++_nReleased;
+    }
+
+    lunchbox::Event* event;
+};
+
+void testAutoReset()
+{
+    lunchbox::Event event;
+    TEST( event.getMode() == lunchbox::Event::AUTO_RESET );
+    TEST( !event.isSet( ));
+    TEST( !event.wait( 10 ));
+
+    event.set();
+    event.set();
+    TEST( event.isSet( ));
+    TEST( event.wait( 0 ));
+    TEST( !event.isSet( ));
+    TEST( !event.wait( 0 ));
+
+    // each set releases one thread
+    _nReleased = 0;
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].event = &event;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        while( event.isSet( ))
+            lunchbox::Thread::yield();
+        event.set();
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    TEST( _nReleased == NTHREADS );
+}
+
+void testManualReset()
+{
+    lunchbox::Event event( lunchbox::Event::MANUAL_RESET, true );
+    TEST( event.isSet( ));
+    TEST( event.wait( 0 ));
+    TEST( event.isSet( ));
+    event.reset();
+    TEST( !event.isSet( ));
+    TEST( !event.wait( 10 ));
+
+    // one set releases all threads
+    _nReleased = 0;
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].event = &event;
+        TEST( threads[ i ].start( ));
+    }
+    event.set();
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    TEST( _nReleased == NTHREADS );
+    TEST( event.isSet( ));
+}
+
+int main( int, char** )
+{
+    testAutoReset();
+    testManualReset();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/flatUUIDHash.h>
+#include <lunchbox/init.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define NKEYS 100000
+
+using lunchbox::uint128_t;
+typedef lunchbox::FlatUUIDHash< std::string > Hash;
+
+void testUUIDs()
+{
+    std::vector< uint128_t > keys;
+    Hash hash;
+    for( size_t i = 0; i < NKEYS; ++i )
+    {
+        keys.push_back( lunchbox::make_UUID( ));
+        TEST( hash.insert( std::make_pair( keys.back(),
+                                           keys.back().getString( ))).second );
+    }
+    TEST( hash.size() == NKEYS );
+    TEST( hash.getCapacity() * 7 / 8 >= NKEYS );
+
+    for( size_t i = 0; i < NKEYS; ++i )
+    {
+        Hash::const_iterator j = hash.find( keys[ i ] );
+        TEST( j != hash.end( ));
+        TEST( j->first == keys[ i ] );
+        TEST( j->second == keys[ i ].getString( ));
+        TEST( !hash.insert( std::make_pair( keys[ i ], "" )).second );
+    }
+    TEST( hash.find( lunchbox::make_UUID( )) == hash.end( ));
+
+    size_t n = 0;
+    for( Hash::const_iterator i = hash.begin(); i != hash.end(); ++i )
+        ++n;
+    TEST( n == NKEYS );
+
+    for( size_t i = 0; i < NKEYS; i += 2 )
+        TEST( hash.erase( keys[ i ] ) == 1 );
+    TEST( hash.size() == NKEYS / 2 );
+    for( size_t i = 0; i < NKEYS; ++i )
+        TEST( hash.count( keys[ i ] ) == i % 2 );
+
+    Hash copy( hash );
+    const size_t capacity = hash.getCapacity();
+    hash.rehash( 0 );
+    TEST( hash.size() == NKEYS / 2 );
+    TEST( hash.getCapacity() < capacity );
+    TEST( hash.getCapacity() == copy.getCapacity( ));
+    for( size_t i = 1; i < NKEYS; i += 2 )
+    {
+        TEST( hash[ keys[ i ]] == keys[ i ].getString( ));
+        TEST( copy[ keys[ i ]] == keys[ i ].getString( ));
+    }
+
+    hash.clear();
+    TEST( hash.empty( ));
+    TEST( hash.begin() == hash.end( ));
+}
+
+void testSequentialKeys()
+{
+    lunchbox::FlatUUIDHash< size_t > hash;
+    hash.reserve( NKEYS );
+    const size_t capacity = hash.getCapacity();
+
+    // erase/insert churn reuses deleted slots without growing
+    for( size_t i = 0; i < NKEYS * 4; ++i )
+    {
+        hash[ uint128_t( i ) ] = i;
+        if( i >= NKEYS / 2 )
+            TEST( hash.erase( uint128_t( i - NKEYS / 2 )) == 1 );
+    }
+    TEST( hash.size() == NKEYS / 2 );
+    TESTINFO( hash.getCapacity() == capacity,
+              hash.getCapacity() << " != " << capacity );
+    for( size_t i = NKEYS * 4 - NKEYS / 2; i < NKEYS * 4; ++i )
+        TEST( hash[ uint128_t( i ) ] == i );
+}
+
+// Keys differing only in their upper 32 bits still spread over all groups
+void testUpperBitKeys( const bool inHigh )
+{
+    const size_t nKeys = 4096;
+    const size_t capacity = lunchbox::detail::flatCapacity( nKeys );
+    const size_t width = lunchbox::detail::FlatGroup::WIDTH;
+    std::vector< size_t > groups( capacity / width, 0 );
+    lunchbox::FlatUUIDHash< size_t > hash;
+
+    for( size_t i = 0; i < nKeys; ++i )
+    {
+        const uint64_t bits = uint64_t( i ) << 32;
+        const uint128_t key = inHigh ? uint128_t( bits, 0 ) :
+                                       uint128_t( 0, bits );
+        const uint64_t home = lunchbox::detail::flatHash( key ) >> 7;
+        ++groups[ ( home & ( capacity - 1 )) / width ];
+        hash[ key ] = i;
+    }
+
+    // eight keys per group on average, no home group may overflow twice
+    const size_t maxKeys = *std::max_element( groups.begin(), groups.end( ));
+    TESTINFO( maxKeys <= 2 * width, maxKeys << " keys in one group" );
+
+    TEST( hash.size() == nKeys );
+    for( size_t i = 0; i < nKeys; ++i )
+    {
+        const uint64_t bits = uint64_t( i ) << 32;
+        TEST( hash[ inHigh ? uint128_t( bits, 0 ) : uint128_t( 0, bits )] ==
+              i );
+    }
+}
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+    testUUIDs();
+    testSequentialKeys();
+    testUpperBitKeys( true );
+    testUpperBitKeys( false );
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -20,8 +20,13 @@
 #define BOOST_TEST_MODULE Future
 
 #include <lunchbox/clock.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/promise.h>
 #include <lunchbox/readyFuture.h>
+#include <lunchbox/requestHandler.h>
+#include <lunchbox/thread.h>
 #include <boost/test/unit_test.hpp>
+#include <deque>
 
 BOOST_AUTO_TEST_CASE( readyFutures )
 {
@@ -68,3 +73,273 @@ BOOST_AUTO_TEST_CASE( perfFuture )
               << nLoops / futureASync / 1000.f << " async futures, "
               << nLoops / present / 1000.f << " normal calls/us" << std::endl;
 }
+
+namespace
+{
+int addOne( lunchbox::Future< int > future ) { return future.wait() + 1; }
+
+uint32_t addOneU( lunchbox::Future< uint32_t > future )
+{
+    return future.wait() + 1;
+}
+
+size_t getLength( lunchbox::Future< std::string > future )
+{
+    return future.wait().length();
+}
+
+bool isDone( lunchbox::Future< void > future )
+{
+    future.wait();
+    return true;
+}
+
+void fail( lunchbox::Future< int > )
+{
+    throw std::runtime_error( "continuation failed" );
+}
+
+/** Runs posted tasks on request. */
+class QueueExecutor : public lunchbox::Executor
+{
+public:
+    void post( const Task& task ) final { tasks.push_back( task ); }
+
+    void run()
+    {
+        while( !tasks.empty( ))
+        {
+            const Task task = tasks.front();
+            tasks.pop_front();
+            task();
+        }
+    }
+
+    std::deque< Task > tasks;
+};
+
+class Fulfiller : public lunchbox::Thread
+{
+public:
+    explicit Fulfiller( lunchbox::Promise< int > promise )
+        : _promise( promise ) {}
+
+    void run() final { _promise.setValue( 41 ); }
+
+private:
+    lunchbox::Promise< int > _promise;
+};
+
+/** Serves queued requests after a varying delay of up to 2 ms. */
+class Server : public lunchbox::Thread
+{
+public:
+    explicit Server( lunchbox::RequestHandler& handler )
+        : _handler( handler ) {}
+
+    void run() final
+    {
+        for( size_t i = 0; ; ++i )
+        {
+            const uint32_t request = requests.pop();
+            if( request == LB_UNDEFINED_UINT32 )
+                return;
+
+            const lunchbox::Clock clock;
+            while( clock.getTimef() < float( i % 20 ) * .1f )
+                lunchbox::Thread::yield();
+            _handler.serveRequest( request, uint32_t( 41 ));
+        }
+    }
+
+    lunchbox::MTQueue< uint32_t > requests;
+
+private:
+    lunchbox::RequestHandler& _handler;
+};
+
+lunchbox::Future< size_t > relinquish( lunchbox::RequestHandler& handler,
+                                       uint32_t& requestID )
+{
+    lunchbox::Request< std::string > request =
+        handler.registerRequest< std::string >();
+    requestID = request.getID();
+    const lunchbox::Future< size_t > length = request.then( getLength );
+    request.relinquish();
+    return length;
+}
+}
+
+BOOST_AUTO_TEST_CASE( promises )
+{
+    lunchbox::Promise< int > promise;
+    lunchbox::Future< int > future = promise.getFuture();
+    BOOST_CHECK( !future.isReady( ));
+    BOOST_CHECK_THROW( future.wait( 10 ), lunchbox::FutureTimeout );
+    promise.setValue( 42 );
+    BOOST_CHECK( future.isReady( ));
+    BOOST_CHECK_EQUAL( future.wait(), 42 );
+
+    lunchbox::Promise< void > done;
+    done.setValue();
+    done.getFuture().wait();
+
+    lunchbox::Promise< int > failed;
+    failed.setException( boost::copy_exception( std::runtime_error( "" )));
+    BOOST_CHECK_THROW( failed.getFuture().wait(), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( brokenPromises )
+{
+    lunchbox::Future< int > orphan = lunchbox::Promise< int >().getFuture();
+    BOOST_CHECK( orphan.isReady( ));
+    BOOST_CHECK_THROW( orphan.wait(), lunchbox::BrokenPromise );
+
+    lunchbox::Promise< int > promise;
+    lunchbox::Future< int > next = promise.getFuture().then( addOne );
+    {
+        lunchbox::Promise< int > copy = promise;
+        promise = lunchbox::Promise< int >();
+    }
+    BOOST_CHECK_THROW( next.wait(), lunchbox::BrokenPromise );
+
+    // relinquished requests drop their continuations and their reference
+    lunchbox::RequestHandler handler;
+    uint32_t requestID = 0;
+    lunchbox::Future< size_t > length = relinquish( handler, requestID );
+    BOOST_CHECK_THROW( length.wait(), lunchbox::BrokenPromise );
+    BOOST_CHECK( !handler.getRequestData( requestID ));
+    handler.serveRequest( requestID, std::string( "ignored" ));
+}
+
+BOOST_AUTO_TEST_CASE( continuations )
+{
+    lunchbox::Promise< int > promise;
+    lunchbox::Future< int > next = promise.getFuture().then( addOne );
+    lunchbox::Future< int > nextNext = next.then( addOne );
+    lunchbox::Future< void > failed = promise.getFuture().then( fail );
+    BOOST_CHECK( !next.isReady( ));
+
+    promise.setValue( 1 );
+    BOOST_CHECK( next.isReady( ));
+    BOOST_CHECK_EQUAL( next.wait(), 2 );
+    BOOST_CHECK_EQUAL( nextNext.wait(), 3 );
+    BOOST_CHECK_THROW( failed.wait(), std::runtime_error );
+
+    // ready futures run their continuation immediately
+    BOOST_CHECK( promise.getFuture().then( addOne ).isReady( ));
+
+    lunchbox::Promise< void > done;
+    lunchbox::Future< bool > isDoneFuture = done.getFuture().then( isDone );
+    done.setValue();
+    BOOST_CHECK( isDoneFuture.wait( ));
+
+    QueueExecutor executor;
+    lunchbox::Promise< int > queued;
+    lunchbox::Future< int > result = queued.getFuture().then( executor,
+                                                              addOne );
+    queued.setValue( 1 );
+    BOOST_CHECK( !result.isReady( ));
+    BOOST_CHECK_EQUAL( executor.tasks.size(), 1 );
+    executor.run();
+    BOOST_CHECK_EQUAL( result.wait(), 2 );
+
+    lunchbox::Promise< int > remote;
+    lunchbox::Future< int > remoteNext = remote.getFuture().then( addOne );
+    Fulfiller fulfiller( remote );
+    BOOST_CHECK( fulfiller.start( ));
+    BOOST_CHECK_EQUAL( remoteNext.wait(), 42 );
+    BOOST_CHECK( fulfiller.join( ));
+}
+
+BOOST_AUTO_TEST_CASE( combinators )
+{
+    std::vector< lunchbox::Promise< int > > promises( 3 );
+    std::vector< lunchbox::Future< int > > futures;
+    for( size_t i = 0; i < promises.size(); ++i )
+        futures.push_back( promises[ i ].getFuture( ));
+
+    lunchbox::Future< void > all = lunchbox::whenAll( futures.begin(),
+                                                      futures.end( ));
+    lunchbox::Future< size_t > any = lunchbox::whenAny( futures.begin(),
+                                                        futures.end( ));
+    BOOST_CHECK( !all.isReady( ));
+    BOOST_CHECK( !any.isReady( ));
+
+    promises[ 1 ].setValue( 1 );
+    BOOST_CHECK_EQUAL( any.wait(), 1 );
+    BOOST_CHECK( !all.isReady( ));
+    promises[ 0 ].setValue( 0 );
+    promises[ 2 ].setValue( 2 );
+    BOOST_CHECK( all.isReady( ));
+
+    BOOST_CHECK( lunchbox::whenAll( futures.end(), futures.end( )).isReady( ));
+    BOOST_CHECK_EQUAL( lunchbox::whenAny( futures.end(), futures.end( )).wait(),
+                       std::numeric_limits< size_t >::max( ));
+
+    // requests notify continuations from the serving thread
+    lunchbox::RequestHandler handler;
+    lunchbox::Request< uint32_t > first =
+        handler.registerRequest< uint32_t >();
+    lunchbox::Request< uint32_t > second =
+        handler.registerRequest< uint32_t >();
+    std::vector< lunchbox::Future< uint32_t > > requests;
+    requests.push_back( first );
+    requests.push_back( second );
+
+    lunchbox::Future< void > both = lunchbox::whenAll( requests.begin(),
+                                                       requests.end( ));
+    lunchbox::Future< size_t > either = lunchbox::whenAny( requests.begin(),
+                                                           requests.end( ));
+    lunchbox::Future< uint32_t > next = second.then( addOneU );
+    BOOST_CHECK( !next.isReady( ));
+
+    handler.serveRequest( second.getID(), uint32_t( 41 ));
+    BOOST_CHECK_EQUAL( either.wait(), 1 );
+    BOOST_CHECK_EQUAL( next.wait(), 42 );
+    BOOST_CHECK( !both.isReady( ));
+
+    handler.serveRequest( first.getID(), uint32_t( 1 ));
+    BOOST_CHECK( both.isReady( ));
+    BOOST_CHECK_EQUAL( first.wait(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( timedOutContinuations )
+{
+    // continuations of timed out requests race the serving thread
+    lunchbox::RequestHandler handler;
+    Server server( handler );
+    BOOST_CHECK( server.start( ));
+
+    size_t nServed = 0;
+    size_t nTimedOut = 0;
+    for( size_t i = 0; i < 2000; ++i )
+    {
+        lunchbox::Request< uint32_t > request =
+            handler.registerRequest< uint32_t >();
+        lunchbox::Future< uint32_t > next = request.then( addOneU );
+        server.requests.push( request.getID( ));
+        try
+        {
+            BOOST_CHECK_EQUAL( request.wait( 1 ), 41 );
+        }
+        catch( const lunchbox::FutureTimeout& )
+        {
+            request.relinquish();
+        }
+
+        try
+        {
+            BOOST_CHECK_EQUAL( next.wait(), 42 );
+            ++nServed;
+        }
+        catch( const std::runtime_error& ) // FutureTimeout of the input
+        {
+            ++nTimedOut;
+        }
+    }
+    server.requests.push( LB_UNDEFINED_UINT32 );
+    BOOST_CHECK( server.join( ));
+    BOOST_CHECK_EQUAL( nServed + nTimedOut, 2000 );
+    BOOST_CHECK( !handler.hasPendingRequests( ));
+}
@@ -0,0 +1,71 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/latch.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 8
+
+lunchbox::a_int32_t _nArrived;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : latch( 0 ) {}
+
+    virtual void run()
+    {
+        ++_nArrived;
+        latch->arriveAndWait();
+        TEST( latch->isOpen( ));
+        TEST( _nArrived == NTHREADS );
+    }
+
+    lunchbox::Latch* latch;
+};
+
+int main( int, char** )
+{
+    lunchbox::Latch open( 0 );
+    TEST( open.isOpen( ));
+    TEST( open.wait( ));
+    TEST( open.wait( 0 ));
+
+    lunchbox::Latch latch( 3 );
+    TEST( latch.getCount() == 3 );
+    TEST( !latch.wait( 10 ));
+    latch.countDown( 2 );
+    TEST( latch.getCount() == 1 );
+    TEST( !latch.isOpen( ));
+    latch.countDown();
+    TEST( latch.isOpen( ));
+    TEST( latch.wait( 10 ));
+
+    lunchbox::Latch threadLatch( NTHREADS );
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].latch = &threadLatch;
+        TEST( threads[ i ].start( ));
+    }
+    TEST( threadLatch.wait( ));
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    return EXIT_SUCCESS;
+}
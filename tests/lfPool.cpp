@@ -0,0 +1,112 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/lfPool.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#include <set>
+
+#define NTHREADS 8
+#define NLOOPS   10000
+#define NITEMS   10
+
+lunchbox::a_int32_t nItems_( 0 );
+
+struct Item
+{
+    Item() : owner( 0 ) { ++nItems_; }
+    ~Item() { --nItems_; }
+    size_t owner;
+};
+
+typedef lunchbox::LFPool< Item > Pool;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : pool( 0 ), index( 0 ) {}
+
+    virtual void run()
+    {
+        Item* items[ NITEMS ];
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                items[ j ] = pool->alloc();
+                TEST( items[ j ]->owner == 0 );
+                items[ j ]->owner = index;
+            }
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                TEST( items[ j ]->owner == index );
+                items[ j ]->owner = 0;
+                pool->release( items[ j ] );
+            }
+        }
+    }
+
+    Pool* pool;
+    size_t index;
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+    {
+        Pool pool;
+        std::set< Item* > items;
+        for( size_t i = 0; i < 10; ++i )
+            items.insert( pool.alloc( ));
+        TEST( nItems_ == 10 );
+
+        for( std::set< Item* >::const_iterator i = items.begin();
+             i != items.end(); ++i )
+        {
+            pool.release( *i );
+        }
+        for( size_t i = 0; i < 10; ++i )
+            TEST( items.count( pool.alloc( )));
+        TEST( nItems_ == 10 );
+
+        for( std::set< Item* >::const_iterator i = items.begin();
+             i != items.end(); ++i )
+        {
+            pool.release( *i );
+        }
+        pool.flush();
+        TEST( nItems_ == 0 );
+
+        // the same item is never handed out twice
+        Thread threads[ NTHREADS ];
+        for( size_t i = 0; i < NTHREADS; ++i )
+        {
+            threads[ i ].pool = &pool;
+            threads[ i ].index = i + 1;
+            TEST( threads[ i ].start( ));
+        }
+        for( size_t i = 0; i < NTHREADS; ++i )
+            TEST( threads[ i ].join( ));
+        TESTINFO( nItems_ <= NTHREADS * NITEMS, nItems_ );
+    }
+    TEST( nItems_ == 0 );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
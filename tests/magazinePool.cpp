@@ -0,0 +1,135 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/magazinePool.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#include <set>
+
+#define NTHREADS 8
+#define NLOOPS   1000
+#define NITEMS   100
+
+lunchbox::a_int32_t nItems_( 0 );
+
+struct Item
+{
+    Item() : owner( 0 ) { ++nItems_; }
+    ~Item() { --nItems_; }
+    size_t owner;
+};
+
+typedef lunchbox::MagazinePool< Item > Pool;
+Pool pool_( 16, 8 );
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : index( 0 ) {}
+
+    virtual void run()
+    {
+        Item* items[ NITEMS ];
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                items[ j ] = pool_.alloc();
+                items[ j ]->owner = index;
+            }
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                TEST( items[ j ]->owner == index );
+                pool_.release( items[ j ] );
+            }
+        }
+    }
+
+    size_t index;
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+    {
+        Pool pool( 4, 1 );
+        std::set< Item* > allocated;
+        Item* items[ 10 ];
+        for( size_t i = 0; i < 10; ++i )
+        {
+            items[ i ] = pool.alloc();
+            allocated.insert( items[ i ] );
+        }
+        TEST( pool.getStats().nCreated == 10 );
+        TEST( pool.getStats().nThreads == 1 );
+
+        // two thread-local magazines, then one in the depot
+        for( size_t i = 0; i < 10; ++i )
+            pool.release( items[ i ] );
+        Pool::Stats stats = pool.getStats();
+        TEST( stats.nStores == 1 );
+        TEST( stats.nCached == 4 );
+        TEST( stats.nDeleted == 0 );
+
+        for( size_t i = 0; i < 10; ++i )
+        {
+            items[ i ] = pool.alloc();
+            TEST( allocated.count( items[ i ] ));
+        }
+        stats = pool.getStats();
+        TEST( stats.nLoads == 1 );
+        TEST( stats.nCached == 0 );
+        TEST( stats.nCreated == 10 );
+
+        // depot holds only one magazine
+        for( size_t i = 0; i < 10; ++i )
+            pool.release( items[ i ] );
+        Item* more[ 8 ];
+        for( size_t i = 0; i < 8; ++i )
+            more[ i ] = new Item;
+        for( size_t i = 0; i < 8; ++i )
+            pool.release( more[ i ] );
+        stats = pool.getStats();
+        TEST( stats.nStores == 2 );
+        TESTINFO( stats.nDeleted == 8, stats.nDeleted );
+        TEST( nItems_ == 10 );
+
+        pool.flush();
+        TESTINFO( nItems_ == 0, nItems_ );
+        TEST( pool.getStats().nCached == 0 );
+
+        pool.release( new Item );
+    }
+    TEST( nItems_ == 0 );
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    // each thread holds at most two magazines, the depot eight
+    TESTINFO( pool_.getStats().nCreated <= NTHREADS * NITEMS, nItems_ );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -215,10 +215,85 @@ void testTimedMonitorComparisons()
     TEST( waiter.join( ));
 }
 
+#define NTHREADS 4
+#define NINCREMENTS 100000
+
+lunchbox::Monitor< uint32_t > counter;
+lunchbox::Monitor< uint128_t > bigCounter;
+
+class Thread3 : public lunchbox::Thread
+{
+public:
+    virtual void run()
+        {
+            for( size_t i = 0; i != NINCREMENTS; ++i )
+            {
+                ++counter;
+                ++bigCounter;
+            }
+        }
+};
+
+void testConcurrentUpdates()
+{
+    Thread3 threads[ NTHREADS ];
+    for( size_t i = 0; i != NTHREADS; ++i )
+        TEST( threads[ i ].start( ));
+
+    TEST( counter.waitEQ( NTHREADS * NINCREMENTS ) ==
+          NTHREADS * NINCREMENTS );
+    TEST( bigCounter.waitEQ( uint128_t( NTHREADS * NINCREMENTS )) ==
+          uint128_t( NTHREADS * NINCREMENTS ));
+    for( size_t i = 0; i != NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    counter |= 1;
+    TEST( counter == ( NTHREADS * NINCREMENTS | 1 ));
+    counter &= 1;
+    TEST( counter == 1 );
+}
+
+lunchbox::Monitor< size_t > stage;
+
+class Thread4 : public lunchbox::Thread
+{
+public:
+    Thread4() : threshold( 0 ), result( 0 ) {}
+    virtual void run() { result = stage.waitGE( threshold ); }
+
+    size_t threshold;
+    size_t result;
+};
+
+void testThresholdWaiters()
+{
+    Thread4 threads[ NTHREADS ];
+    for( size_t i = 0; i != NTHREADS; ++i )
+    {
+        threads[ i ].threshold = NTHREADS - i;
+        TEST( threads[ i ].start( ));
+    }
+
+    // timed out waiters leave the other waiters intact
+    TEST( !stage.timedWaitEQ( NTHREADS + 1, 10 ));
+    TEST( !stage.timedWaitNE( 0, 10 ));
+
+    for( size_t i = 0; i != NTHREADS; ++i )
+    {
+        ++stage;
+        TEST( threads[ NTHREADS - i - 1 ].join( ));
+        TESTINFO( threads[ NTHREADS - i - 1 ].result >= i + 1,
+                  threads[ NTHREADS - i - 1 ].result );
+    }
+    TEST( stage.waitNE( 0, 1 ) == NTHREADS );
+}
+
 int main( int, char** )
 {
     testSimpleMonitor();
     testMonitorComparisons();
     testTimedMonitorComparisons();
+    testConcurrentUpdates();
+    testThresholdWaiters();
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,95 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/buffer.h>
+#include <lunchbox/parallelMemory.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+
+bool check( const uint8_t* data, const size_t size, const uint8_t start )
+{
+    for( size_t i = 0; i < size; ++i )
+        if( data[ i ] != uint8_t( start + i ))
+            return false;
+    return true;
+}
+
+void testCopy( const size_t size, const size_t offset )
+{
+    lunchbox::Bufferb from( size + offset );
+    lunchbox::Bufferb to( size + offset );
+    for( size_t i = 0; i < size; ++i )
+        from[ i + offset ] = uint8_t( i );
+
+    lunchbox::parallelCopy( to.getData() + offset, from.getData() + offset,
+                            size );
+    TESTINFO( check( to.getData() + offset, size, 0 ), size );
+
+    lunchbox::parallelSet( to.getData() + offset, 42, size );
+    for( size_t i = 0; i < size; ++i )
+        TESTINFO( to[ i + offset ] == 42, size );
+}
+
+class Thread : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        for( size_t i = 0; i < 10; ++i )
+            testCopy( 8 * LB_1MB + 3, 1 );
+    }
+};
+
+int main( int, char** )
+{
+    const size_t threshold = lunchbox::getParallelMemoryThreshold();
+    testCopy( 0, 0 );
+    testCopy( 100, 1 );
+    testCopy( threshold - 1, 0 );
+    testCopy( threshold, 0 );
+    testCopy( 3 * threshold + 13, 7 );
+    testCopy( LB_64MB + 5, 3 ); // non-temporal stores
+
+    // concurrent operations
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].start( ));
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    // Buffer opt-in
+    lunchbox::Buffer< uint32_t > buffer( threshold );
+    for( size_t i = 0; i < threshold; ++i )
+        buffer[ i ] = uint32_t( i );
+    lunchbox::Buffer< uint32_t > copy;
+    copy.replace( buffer, true );
+    TEST( copy.getSize() == threshold );
+    TEST( copy[ threshold - 1 ] == threshold - 1 );
+    copy.setZero( true );
+    for( size_t i = 0; i < threshold; ++i )
+        TEST( copy[ i ] == 0 );
+    buffer.setZero();
+    TEST( buffer[ threshold - 1 ] == 0 );
+
+    // the workers are restarted after a shutdown
+    lunchbox::shutdownParallelMemory();
+    testCopy( threshold, 5 );
+    lunchbox::shutdownParallelMemory();
+    return EXIT_SUCCESS;
+}
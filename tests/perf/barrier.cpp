@@ -0,0 +1,110 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <test.h>
+
+#include <lunchbox/barrier.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/thread.h>
+
+#include <iomanip>
+#include <iostream>
+
+#define MAXTHREADS 128
+#define NPHASES    2000
+
+// The barrier emulation using a counter, as used before Barrier existed
+class MonitorBarrier
+{
+public:
+    explicit MonitorBarrier( const size_t size ) : _size( size ) {}
+
+    bool enter( size_t, const size_t phase )
+    {
+        ++_counter;
+        _counter.waitGE( ( phase + 1 ) * _size );
+        return false;
+    }
+
+private:
+    const size_t _size;
+    lunchbox::Monitor< size_t > _counter;
+};
+
+class LBBarrier : public lunchbox::Barrier
+{
+public:
+    LBBarrier( const size_t size, const Mode mode )
+        : lunchbox::Barrier( size, mode ) {}
+
+    bool enter( const size_t index, size_t )
+        { return lunchbox::Barrier::enter( index ); }
+};
+
+template< class B > class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : barrier( 0 ), index( 0 ) {}
+
+    virtual void run()
+    {
+        for( size_t i = 0; i < NPHASES; ++i )
+            barrier->enter( index, i );
+    }
+
+    B* barrier;
+    size_t index;
+};
+
+template< class B >
+void _test( B& barrier, const size_t nThreads, const std::string& name )
+{
+    Thread< B > threads[ MAXTHREADS ];
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        threads[ i ].barrier = &barrier;
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < nThreads; ++i )
+        TEST( threads[ i ].join( ));
+    const float time = clock.getTimef();
+
+    std::cout << std::setw( 8 ) << name << ", " << std::setw( 7 ) << nThreads
+              << ", " << std::setw( 10 ) << time * 1000.f / float( NPHASES )
+              << std::endl;
+}
+
+int main( int, char** )
+{
+    std::cout << " Barrier, threads, us/phase" << std::endl;
+    for( size_t i = 2; i <= MAXTHREADS; i = i << 1 )
+    {
+        MonitorBarrier monitor( i );
+        _test( monitor, i, "Monitor" );
+
+        LBBarrier central( i, lunchbox::Barrier::CENTRAL );
+        _test( central, i, "Central" );
+
+        LBBarrier tree( i, lunchbox::Barrier::TREE );
+        _test( tree, i, "Tree" );
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include "test.h"
+
+#include <lunchbox/clock.h>
+#include <lunchbox/concurrentHashMap.h>
+#include <lunchbox/init.h>
+#include <lunchbox/lockable.h>
+#include <lunchbox/rng.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/spinLock.h>
+#include <lunchbox/thread.h>
+
+#include <iostream>
+
+#define MAXTHREADS 64
+#define NKEYS      65536
+#define TIME       500  // ms
+
+typedef stde::hash_map< uint32_t, uint32_t > Hash;
+typedef lunchbox::Lockable< Hash, lunchbox::SpinLock > LockedHash;
+typedef lunchbox::ConcurrentHashMap< uint32_t, uint32_t > ConcurrentHash;
+
+bool _running = false;
+
+/** Uniform interface over the benchmarked maps, 75% reads */
+template< class M > struct Ops;
+
+template<> struct Ops< LockedHash >
+{
+    static bool find( const LockedHash& map, const uint32_t key )
+    {
+        lunchbox::ScopedFastRead mutex( map.lock );
+        return map->find( key ) != map->end();
+    }
+
+    static void set( LockedHash& map, const uint32_t key )
+    {
+        lunchbox::ScopedFastWrite mutex( map.lock );
+        (*map)[ key ] = key;
+    }
+
+    static void erase( LockedHash& map, const uint32_t key )
+    {
+        lunchbox::ScopedFastWrite mutex( map.lock );
+        map->erase( key );
+    }
+};
+
+template<> struct Ops< ConcurrentHash >
+{
+    static bool find( const ConcurrentHash& map, const uint32_t key )
+        { return map.contains( key ); }
+    static void set( ConcurrentHash& map, const uint32_t key )
+        { map.set( key, key ); }
+    static void erase( ConcurrentHash& map, const uint32_t key )
+        { map.erase( key ); }
+};
+
+template< class M > class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : map( 0 ), ops( 0 ), seed( 0 ) {}
+
+    M* map;
+    size_t ops;
+    uint32_t seed;
+
+    virtual void run()
+    {
+        ops = 0;
+        uint32_t key = seed;
+        while( LB_LIKELY( _running ))
+        {
+            for( size_t i = 0; i < 100; ++i )
+            {
+                key = key * 1664525u + 1013904223u; // LCG
+                const uint32_t index = key % NKEYS;
+                switch( key >> 29 )
+                {
+                case 0:
+                    Ops< M >::erase( *map, index );
+                    break;
+                case 1:
+                    Ops< M >::set( *map, index );
+                    break;
+                default:
+                    Ops< M >::find( *map, index );
+                }
+            }
+            ops += 100;
+        }
+    }
+};
+
+template< class M > void _test( const std::string& name )
+{
+    M map;
+    for( uint32_t i = 0; i < NKEYS; i += 2 )
+        Ops< M >::set( map, i );
+
+    lunchbox::RNG rng;
+    Thread< M > threads[ MAXTHREADS ];
+    for( size_t i = 1; i <= MAXTHREADS; i = i << 1 )
+    {
+        _running = true;
+        for( size_t j = 0; j < i; ++j )
+        {
+            threads[ j ].map = &map;
+            threads[ j ].seed = rng.get< uint32_t >();
+            TEST( threads[ j ].start( ));
+        }
+
+        lunchbox::Clock clock;
+        lunchbox::sleep( TIME );
+        _running = false;
+
+        size_t ops = 0;
+        for( size_t j = 0; j < i; ++j )
+        {
+            TEST( threads[ j ].join( ));
+            ops += threads[ j ].ops;
+        }
+        const float time = clock.getTimef();
+
+        std::cout << std::setw(20) << name << ", " << std::setw(12)
+                  << ops / time << ", " << std::setw(3) << i << std::endl;
+    }
+}
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    std::cout << "               Class,       ops/ms, threads" << std::endl;
+    _test< LockedHash >( "Lockable< hash_map >" );
+    std::cout << std::endl;
+    _test< ConcurrentHash >( "ConcurrentHashMap" );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
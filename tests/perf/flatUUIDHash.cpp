@@ -0,0 +1,90 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "test.h"
+
+#include <lunchbox/clock.h>
+#include <lunchbox/flatUUIDHash.h>
+#include <lunchbox/hash.h>
+#include <lunchbox/init.h>
+
+#include <iostream>
+#include <vector>
+
+#define NLOOKUPS 4000000
+
+using lunchbox::uint128_t;
+typedef std::vector< uint128_t > UUIDs;
+
+template< class H > void _test( const std::string& name, const UUIDs& keys,
+                                const UUIDs& missing, const bool reserve )
+{
+    const size_t nKeys = keys.size();
+    lunchbox::Clock clock;
+    H hash;
+    if( reserve ) // rehash() is also provided by the TR1 UUIDHash
+        hash.rehash( nKeys );
+    for( size_t i = 0; i < nKeys; ++i )
+        hash[ keys[ i ]] = i;
+    const float insertTime = clock.resetTimef();
+
+    size_t found = 0;
+    for( size_t i = 0; i < NLOOKUPS; ++i )
+        if( hash.find( keys[ ( i * 7919 ) % nKeys ] ) != hash.end( ))
+            ++found;
+    const float hitTime = clock.resetTimef();
+    TEST( found == NLOOKUPS );
+
+    for( size_t i = 0; i < NLOOKUPS; ++i )
+        if( hash.find( missing[ i % missing.size() ] ) != hash.end( ))
+            ++found;
+    const float missTime = clock.resetTimef();
+    TEST( found == NLOOKUPS );
+
+    std::cout << std::setw(25) << name << ", " << std::setw(8) << nKeys
+              << ", " << std::setw(12) << nKeys / insertTime << ", "
+              << std::setw(12) << NLOOKUPS / hitTime << ", "
+              << std::setw(12) << NLOOKUPS / missTime << std::endl;
+}
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    UUIDs missing( 65536 );
+    for( size_t i = 0; i < missing.size(); ++i )
+        missing[ i ] = lunchbox::make_UUID();
+
+    std::cout << "                    Class,     keys,   inserts/ms,      hits/ms,"
+              << "    misses/ms" << std::endl;
+    for( size_t nKeys = 1024; nKeys <= 4*LB_1MB; nKeys = nKeys << 2 )
+    {
+        UUIDs keys( nKeys );
+        for( size_t i = 0; i < nKeys; ++i )
+            keys[ i ] = lunchbox::make_UUID();
+
+        _test< lunchbox::UUIDHash< size_t > >( "UUIDHash", keys, missing,
+                                               false );
+        _test< lunchbox::FlatUUIDHash< size_t > >( "FlatUUIDHash", keys,
+                                                   missing, false );
+        _test< lunchbox::FlatUUIDHash< size_t > >( "FlatUUIDHash reserved",
+                                                   keys, missing, true );
+    }
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
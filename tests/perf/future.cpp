@@ -0,0 +1,99 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/promise.h>
+#include <lunchbox/readyFuture.h>
+
+#include <iomanip>
+#include <iostream>
+
+#define NLOOPS 1000000
+
+namespace
+{
+// The allocated ready future used before futures stored ready values inline
+lunchbox::f_bool_t _allocated( const size_t )
+{
+    return lunchbox::f_bool_t( new lunchbox::FutureBool< true > );
+}
+
+lunchbox::f_bool_t _ready( const size_t )
+{
+    return lunchbox::makeReadyFuture( true );
+}
+
+lunchbox::f_bool_t _deferred( const size_t )
+{
+    lunchbox::Promise< bool > promise;
+    lunchbox::f_bool_t future = promise.getFuture();
+    promise.setValue( true );
+    return future;
+}
+
+bool _isTrue( lunchbox::f_bool_t future )
+{
+    return future.wait();
+}
+
+lunchbox::f_bool_t _readyThen( const size_t )
+{
+    return lunchbox::makeReadyFuture( true ).then( _isTrue );
+}
+
+lunchbox::f_bool_t _deferredThen( const size_t )
+{
+    lunchbox::Promise< bool > promise;
+    lunchbox::f_bool_t future = promise.getFuture().then( _isTrue );
+    promise.setValue( true );
+    return future;
+}
+
+typedef lunchbox::f_bool_t (*Factory)( size_t );
+
+void _test( const std::string& name, const Factory factory )
+{
+    size_t nTrue = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < NLOOPS; ++i )
+    {
+        lunchbox::f_bool_t future = factory( i );
+        if( future.wait( ))
+            ++nTrue;
+    }
+    const float time = clock.getTimef();
+    TEST( nTrue == NLOOPS );
+
+    std::cout << std::setw(14) << name << ", " << std::setw(10)
+              << NLOOPS / time << std::endl;
+}
+}
+
+int main( int, char** )
+{
+    // ready futures store their value inline, allocated and deferred futures
+    // need a shared state
+    std::cout << "        Future, futures/ms" << std::endl;
+    _test( "allocated", _allocated );
+    _test( "ready", _ready );
+    _test( "deferred", _deferred );
+    _test( "ready then", _readyThen );
+    _test( "deferred then", _deferredThen );
+    return EXIT_SUCCESS;
+}
@@ -119,6 +119,23 @@ int main( int argc, char **argv )
                   << 1.f / memsetTime * 1000.f << std::endl;
     }
 
+    // library-level parallel copy and set, using a single calling thread
+    void* const from = ::malloc( LB_1GB );
+    void* const to = ::malloc( LB_1GB );
+    ::memset( from, 0, LB_1GB );
+    ::memset( to, 0, LB_1GB );
+
+    lunchbox::Clock clock;
+    lunchbox::parallelCopy( to, from, LB_1GB );
+    const float copyTime = clock.resetTimef();
+    lunchbox::parallelSet( to, 42, LB_1GB );
+    const float setTime = clock.getTimef();
+    std::cout << "parallel, " << 1.f / copyTime * 1000.f << ", , "
+              << 1.f / setTime * 1000.f << std::endl;
+
+    ::free( to );
+    ::free( from );
+
     TEST( lunchbox::exit( ));
     return EXIT_SUCCESS;
 }
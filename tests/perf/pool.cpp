@@ -0,0 +1,111 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include "test.h"
+
+#include <lunchbox/clock.h>
+#include <lunchbox/init.h>
+#include <lunchbox/lfPool.h>
+#include <lunchbox/magazinePool.h>
+#include <lunchbox/pool.h>
+#include <lunchbox/slabPool.h>
+#include <lunchbox/sleep.h>
+#include <lunchbox/thread.h>
+
+#include <iostream>
+
+#define MAXTHREADS 64
+#define NITEMS     16
+#define TIME       500  // ms
+
+struct Item
+{
+    uint64_t data[ 8 ];
+};
+
+bool _running = false;
+
+template< class P > class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : pool( 0 ), ops( 0 ) {}
+
+    P* pool;
+    size_t ops;
+
+    virtual void run()
+    {
+        ops = 0;
+        Item* items[ NITEMS ];
+        while( LB_LIKELY( _running ))
+        {
+            for( size_t i = 0; i < NITEMS; ++i )
+                items[ i ] = pool->alloc();
+            for( size_t i = 0; i < NITEMS; ++i )
+                pool->release( items[ i ] );
+            ops += NITEMS;
+        }
+    }
+};
+
+template< class P > void _test( const std::string& name )
+{
+    static P pool; // outlive the thread-local caches of exited threads
+    Thread< P > threads[ MAXTHREADS ];
+    for( size_t i = 1; i <= MAXTHREADS; i = i << 1 )
+    {
+        _running = true;
+        for( size_t j = 0; j < i; ++j )
+        {
+            threads[ j ].pool = &pool;
+            TEST( threads[ j ].start( ));
+        }
+
+        lunchbox::Clock clock;
+        lunchbox::sleep( TIME );
+        _running = false;
+
+        size_t ops = 0;
+        for( size_t j = 0; j < i; ++j )
+        {
+            TEST( threads[ j ].join( ));
+            ops += threads[ j ].ops;
+        }
+        const float time = clock.getTimef();
+
+        std::cout << std::setw(20) << name << ", " << std::setw(12)
+                  << ops / time << ", " << std::setw(3) << i << std::endl;
+    }
+}
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    std::cout << "               Class,  allocs/ms, threads" << std::endl;
+    _test< lunchbox::Pool< Item, true > >( "Pool< T, true >" );
+    std::cout << std::endl;
+    _test< lunchbox::SlabPool< Item, true > >( "SlabPool< T, true >" );
+    std::cout << std::endl;
+    _test< lunchbox::LFPool< Item > >( "LFPool" );
+    std::cout << std::endl;
+    _test< lunchbox::MagazinePool< Item > >( "MagazinePool" );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "test.h"
+
+#include <lunchbox/buffer.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/init.h>
+#include <lunchbox/smallBuffer.h>
+
+#include <iostream>
+
+#define NMESSAGES 1000000
+#define HEADER    16
+
+size_t nAllocs_ = 0;
+
+struct CountingAllocator
+{
+    static void* allocate( const size_t size )
+    {
+        ++nAllocs_;
+        return lunchbox::MallocAllocator::allocate( size );
+    }
+
+    static void* reallocate( void* ptr, const size_t oldSize,
+                             const size_t newSize )
+    {
+        ++nAllocs_;
+        return lunchbox::MallocAllocator::reallocate( ptr, oldSize, newSize );
+    }
+
+    static void deallocate( void* ptr, const size_t size )
+        { lunchbox::MallocAllocator::deallocate( ptr, size ); }
+};
+
+typedef lunchbox::Buffer< uint8_t, CountingAllocator > Buffer;
+typedef lunchbox::SmallBuffer< uint8_t, 256, CountingAllocator > SmallBuffer;
+
+// Assemble and consume a small command packet of up to 256 bytes
+template< class B > void _test( const std::string& name,
+                                const size_t maxPayload )
+{
+    uint8_t header[ HEADER ] = { 0 };
+    uint8_t payload[ 1024 ] = { 0 };
+    size_t checksum = 0;
+
+    nAllocs_ = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < NMESSAGES; ++i )
+    {
+        B packet;
+        packet.append( header, HEADER );
+        packet.append( payload, 1 + ( i * 7 ) % maxPayload );
+        checksum += packet.getSize();
+    }
+    const float time = clock.getTimef();
+    TEST( checksum > 0 );
+
+    std::cout << std::setw(12) << name << ", " << std::setw(7) << maxPayload
+              << ", " << std::setw(10) << NMESSAGES / time << ", "
+              << std::setw(9) << float( nAllocs_ ) / NMESSAGES << std::endl;
+}
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    std::cout << "       Class, payload, packets/ms, allocs/op" << std::endl;
+    for( size_t payload = 64; payload <= 1024; payload = payload << 2 )
+    {
+        _test< Buffer >( "Buffer", payload );
+        _test< SmallBuffer >( "SmallBuffer", payload );
+    }
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
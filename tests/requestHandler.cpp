@@ -24,10 +24,15 @@
 #include <lunchbox/mtQueue.h>
 #include <lunchbox/requestHandler.h>
 #include <lunchbox/sleep.h>
+#include <lunchbox/slotMap.h>
 #include <lunchbox/thread.h>
 #include <lunchbox/uint128_t.h>
 
+#include <string>
+#include <vector>
+
 using lunchbox::uint128_t;
+typedef std::vector< std::string > Strings;
 
 lunchbox::RequestHandler handler_;
 lunchbox::MTQueue< uint32_t > requestQ_;
@@ -63,9 +68,38 @@ public:
         request = requestQ_.pop();
         TEST( handler_.getRequestData( request ) == ++payload );
         handler_.serveRequest( request, uuid );
+
+        request = requestQ_.pop();
+        TEST( handler_.getRequestData( request ) == ++payload );
+        handler_.serveRequest( request, std::string( "lunchbox" ));
+
+        request = requestQ_.pop();
+        const Strings strings( 1000, "lunchbox" );
+        handler_.serveRequest( request, strings );
     }
 };
 
+// registering more requests than the slot map supports fails loudly
+void testExhaustion()
+{
+    lunchbox::RequestHandler handler;
+    std::vector< uint32_t > requests;
+    try
+    {
+        for( ;; )
+            requests.push_back( handler.registerRequest( ));
+    }
+    catch( const std::runtime_error& ) {}
+    TESTINFO( requests.size() == lunchbox::SlotMap< void* >::MAX_SIZE,
+              requests.size( ));
+
+    handler.unregisterRequest( requests.back( ));
+    requests.back() = handler.registerRequest();
+    for( size_t i = 0; i < requests.size(); ++i )
+        handler.unregisterRequest( requests[ i ] );
+    TEST( !handler.hasPendingRequests( ));
+}
+
 int main( int, char** )
 {
     uint8_t* payload = (uint8_t*)42;
@@ -99,6 +133,68 @@ int main( int, char** )
     TEST( uint128Future.wait() == uuid );
     TEST( handler_.isRequestServed( voidFuture.getID( )));
 
+    lunchbox::Request< std::string > stringFuture =
+        handler_.registerRequest< std::string >( ++payload );
+    requestQ_.push( stringFuture.getID( ));
+    TEST( stringFuture.wait() == "lunchbox" );
+
+    lunchbox::Request< Strings > stringsFuture =
+        handler_.registerRequest< Strings >();
+    requestQ_.push( stringsFuture.getID( ));
+    const Strings strings = stringsFuture.wait();
+    TEST( strings.size() == 1000 );
+    TEST( strings.back() == "lunchbox" );
+
     TEST( thread.join( ));
+
+    // waitRequest() unregisters timed out requests, stale IDs are ignored
+    request = handler_.registerRequest( ++payload );
+    TEST( !handler_.waitRequest( request, boolOut, 10 ));
+    TEST( !handler_.isRequestReady( request ));
+    handler_.unregisterRequest( request );
+
+    const uint32_t reused = handler_.registerRequest( ++payload );
+    TEST( reused != request );
+    handler_.serveRequest( request, true );
+    TEST( !handler_.isRequestReady( reused ));
+    TEST( handler_.getRequestData( request ) == 0 );
+    handler_.serveRequest( reused, true );
+    TEST( handler_.waitRequest( reused, boolOut ));
+
+    // relinquished typed requests are unregistered with their last reference
+    {
+        lunchbox::Request< std::string > relinquished =
+            handler_.registerRequest< std::string >();
+        request = relinquished.getID();
+        relinquished.relinquish();
+    }
+    TEST( handler_.getRequestData( request ) == 0 );
+    handler_.serveRequest( request, std::string( "ignored" ));
+
+    // results of another type than the request's fail loudly
+    lunchbox::Request< std::string > text =
+        handler_.registerRequest< std::string >();
+    try
+    {
+        handler_.serveRequest( text.getID(), "lunchbox" );
+        TEST( !"served a std::string request with a const char*" );
+    }
+    catch( const std::runtime_error& ) {}
+    TEST( !text.isReady( ));
+
+    lunchbox::Request< uint32_t > number =
+        handler_.registerRequest< uint32_t >();
+    try
+    {
+        handler_.serveRequest( number.getID(), 42 );
+        TEST( !"served an uint32_t request with an int" );
+    }
+    catch( const std::runtime_error& ) {}
+
+    handler_.serveRequest( text.getID(), std::string( "lunchbox" ));
+    handler_.serveRequest( number.getID(), uint32_t( 42 ));
+    TEST( text.wait() == "lunchbox" );
+    TEST( number.wait() == 42 );
+    testExhaustion();
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,75 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/semaphore.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+#define NLOOPS 10000
+#define NSLOTS 2
+
+lunchbox::Semaphore _slots( NSLOTS );
+lunchbox::a_int32_t _nInside;
+lunchbox::a_int32_t _maxInside;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            TEST( _slots.acquire( ));
+            const int32_t inside = ++_nInside;
+            TESTINFO( inside <= NSLOTS, inside );
+            if( inside > _maxInside )
+                _maxInside = inside;
+            --_nInside;
+            _slots.release();
+        }
+    }
+};
+
+int main( int, char** )
+{
+    lunchbox::Semaphore semaphore;
+    TEST( semaphore.getCount() == 0 );
+    TEST( !semaphore.tryAcquire( ));
+
+    lunchbox::Clock clock;
+    TEST( !semaphore.acquire( 50 ));
+    TESTINFO( clock.getTimef() >= 49.f, clock.getTimef( ));
+
+    semaphore.release( 2 );
+    TEST( semaphore.getCount() == 2 );
+    TEST( semaphore.acquire( 0 ));
+    TEST( semaphore.tryAcquire( ));
+    TEST( !semaphore.tryAcquire( ));
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].start( ));
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    TEST( _slots.getCount() == NSLOTS );
+    TEST( _maxInside <= NSLOTS );
+    return EXIT_SUCCESS;
+}
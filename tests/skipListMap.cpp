@@ -0,0 +1,130 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/skipListMap.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 8
+#define NKEYS    10000
+
+typedef lunchbox::SkipListMap< uint32_t, uint32_t > Map;
+Map map_;
+lunchbox::a_int32_t running_( NTHREADS );
+
+struct CheckOrder
+{
+    CheckOrder() : last( 0 ), first( true ) {}
+    void operator()( const uint32_t& key, const uint32_t& value )
+    {
+        TESTINFO( first || key > last, key << " <= " << last );
+        TEST( value == key * 2 );
+        last = key;
+        first = false;
+    }
+    uint32_t last;
+    bool first;
+};
+
+class Writer : public lunchbox::Thread
+{
+public:
+    Writer() : index( 0 ) {}
+
+    virtual void run()
+    {
+        // interleave the keys of all threads
+        for( uint32_t i = index; i < NTHREADS * NKEYS; i += NTHREADS )
+            TEST( map_.insert( i, i * 2 ));
+
+        for( uint32_t i = index; i < NTHREADS * NKEYS; i += NTHREADS )
+        {
+            uint32_t value = 0;
+            TEST( map_.find( i, value ));
+            TEST( value == i * 2 );
+            if( i % 2 )
+                TEST( map_.erase( i ));
+        }
+        --running_;
+    }
+
+    uint32_t index;
+};
+
+class Reader : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        while( running_ > 0 )
+            map_.forEach( CheckOrder( ));
+    }
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    Map map;
+    uint32_t key = 0;
+    uint32_t value = 0;
+    TEST( map.empty( ));
+    TEST( !map.find( 42, value ));
+    TEST( map.insert( 42, 84 ));
+    TEST( !map.insert( 42, 17 ));
+    TEST( map.find( 42, value ));
+    TEST( value == 84 );
+    TEST( map.insert( 10, 20 ));
+    TEST( map.insert( 50, 100 ));
+    TEST( map.size() == 3 );
+
+    TEST( map.lowerBound( 11, key, value ));
+    TEST( key == 42 && value == 84 );
+    TEST( map.lowerBound( 50, key, value ));
+    TEST( key == 50 );
+    TEST( !map.lowerBound( 51, key, value ));
+    TEST( map.forEach( 10, 50, CheckOrder( )) == 2 );
+    TEST( map.forEach( CheckOrder( )) == 3 );
+
+    TEST( map.erase( 42 ));
+    TEST( !map.erase( 42 ));
+    TEST( !map.contains( 42 ));
+    TEST( map.insert( 42, 84 ));
+    TEST( map.contains( 42 ));
+    TEST( map.size() == 3 );
+
+    Reader reader;
+    TEST( reader.start( ));
+    Writer writers[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        writers[ i ].index = i;
+        TEST( writers[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( writers[ i ].join( ));
+    TEST( reader.join( ));
+
+    TESTINFO( map_.size() == NTHREADS * NKEYS / 2, map_.size( ));
+    TEST( map_.forEach( CheckOrder( )) == NTHREADS * NKEYS / 2 );
+    for( uint32_t i = 0; i < NTHREADS * NKEYS; ++i )
+        TESTINFO( map_.contains( i ) == !( i % 2 ), i );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/slabPool.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+#define NLOOPS   1000
+#define NITEMS   100
+
+lunchbox::a_int32_t nItems_( 0 );
+
+struct Item
+{
+    Item() : owner( 0 ) { ++nItems_; }
+    ~Item() { --nItems_; }
+    size_t owner;
+    double payload;
+};
+
+typedef lunchbox::SlabPool< Item > Pool;
+typedef lunchbox::SlabPool< Item, true > LockedPool;
+LockedPool pool_( 16 );
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : index( 0 ) {}
+
+    virtual void run()
+    {
+        Item* items[ NITEMS ];
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                items[ j ] = pool_.alloc();
+                items[ j ]->owner = index;
+            }
+            for( size_t j = 0; j < NITEMS; ++j )
+            {
+                TEST( items[ j ]->owner == index );
+                pool_.release( items[ j ] );
+            }
+        }
+    }
+
+    size_t index;
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+    {
+        Pool pool( 8 );
+        Item* items[ 20 ];
+        for( size_t i = 0; i < 20; ++i )
+            items[ i ] = pool.alloc();
+        TEST( pool.getNChunks() == 3 );
+        TEST( pool.getNUsed() == 20 );
+        TEST( nItems_ == 20 );
+
+        // items of one chunk are adjacent and cache-line aligned
+        TEST(( reinterpret_cast< uintptr_t >( items[ 0 ] ) & 63 ) == 0 );
+        for( size_t i = 1; i < 8; ++i )
+            TEST( items[ i ] > items[ i - 1 ] &&
+                  reinterpret_cast< char* >( items[ i ] ) -
+                  reinterpret_cast< char* >( items[ i - 1 ] ) < 64 );
+
+        // released items are reused without construction
+        Item* item = items[ 3 ];
+        item->owner = 42;
+        pool.release( item );
+        TEST( pool.alloc() == item );
+        TEST( item->owner == 42 );
+        TEST( nItems_ == 20 );
+
+        // entirely free chunks are destroyed, except the last available one
+        for( size_t i = 0; i < 20; ++i )
+            pool.release( items[ i ] );
+        TEST( pool.getNUsed() == 0 );
+        TESTINFO( pool.getNChunks() == 1, pool.getNChunks( ));
+
+        pool.flush();
+        TEST( pool.getNChunks() == 0 );
+        TEST( nItems_ == 0 );
+
+        // prewarming constructs items upfront and keeps their chunks
+        pool.reserve( 20 );
+        TEST( pool.getNChunks() == 3 );
+        TEST( nItems_ == 24 );
+        for( size_t i = 0; i < 20; ++i )
+            items[ i ] = pool.alloc();
+        TEST( nItems_ == 24 );
+        for( size_t i = 0; i < 20; ++i )
+            pool.release( items[ i ] );
+        TEST( pool.getNChunks() == 3 );
+        TEST( nItems_ == 24 );
+    }
+    TEST( nItems_ == 0 );
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    TEST( pool_.getNUsed() == 0 );
+    TEST( pool_.getNChunks() <= NTHREADS * NITEMS / 16 );
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/slotMap.h>
+#include <lunchbox/init.h>
+#include <lunchbox/thread.h>
+
+#include <vector>
+
+#define NTHREADS 8
+#define NLOOPS   1000
+#define NIDS     100
+
+typedef lunchbox::SlotMap< uint32_t > Map;
+Map map_;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    Thread() : index( 0 ) {}
+
+    virtual void run()
+    {
+        std::vector< uint32_t > ids( NIDS );
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            for( size_t j = 0; j < NIDS; ++j )
+            {
+                ids[ j ] = map_.insert( index );
+                TEST( ids[ j ] != LB_UNDEFINED_UINT32 );
+            }
+
+            for( size_t j = 0; j < NIDS; ++j )
+            {
+                uint32_t value = 0;
+                TEST( map_.find( ids[ j ], value ));
+                TESTINFO( value == index, value << " != " << index );
+                TEST( map_.erase( ids[ j ], value ));
+                TEST( value == index );
+                TEST( !map_.contains( ids[ j ] ));
+            }
+        }
+    }
+
+    uint32_t index;
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+
+    Map map;
+    uint32_t value = 0;
+    TEST( map.empty( ));
+    TEST( !map.find( 0, value ));
+    TEST( !map.find( LB_UNDEFINED_UINT32, value ));
+
+    const uint32_t first = map.insert( 42 );
+    TEST( first != 0 && first != LB_UNDEFINED_UINT32 );
+    TEST( map.find( first, value ));
+    TEST( value == 42 );
+    TEST( map.size() == 1 );
+
+    // stale identifiers are detected when a slot is reused
+    TEST( map.erase( first ));
+    TEST( !map.erase( first ));
+    TEST( !map.contains( first ));
+    const uint32_t second = map.insert( 17 );
+    TEST( Map::getIndex( second ) == Map::getIndex( first ));
+    TEST( second != first );
+    TEST( !map.find( first, value ));
+    TEST( map.find( second, value ));
+    TEST( value == 17 );
+    TEST( map.getCapacity() == 1 );
+
+    // generations wrap around without handing out identifier 0
+    TEST( map.erase( second ));
+    for( size_t i = 0; i < ( 1u << Map::GENERATION_BITS ) + 1; ++i )
+    {
+        const uint32_t id = map.insert( uint32_t( i ));
+        TEST( id != 0 );
+        TEST( map.erase( id ));
+    }
+    TEST( map.empty( ));
+    TEST( map.getCapacity() == 1 );
+
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        threads[ i ].index = i;
+        TEST( threads[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+
+    TEST( map_.empty( ));
+    TESTINFO( map_.getCapacity() <= NTHREADS * NIDS, map_.getCapacity( ));
+
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
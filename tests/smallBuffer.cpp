@@ -0,0 +1,139 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/smallBuffer.h>
+
+size_t nAllocs_ = 0;
+size_t nFrees_ = 0;
+
+struct CountingAllocator
+{
+    static void* allocate( const size_t size )
+    {
+        ++nAllocs_;
+        return lunchbox::MallocAllocator::allocate( size );
+    }
+
+    static void* reallocate( void* ptr, const size_t oldSize,
+                             const size_t newSize )
+    {
+        if( !ptr )
+            ++nAllocs_;
+        return lunchbox::MallocAllocator::reallocate( ptr, oldSize, newSize );
+    }
+
+    static void deallocate( void* ptr, const size_t size )
+    {
+        if( ptr )
+            ++nFrees_;
+        lunchbox::MallocAllocator::deallocate( ptr, size );
+    }
+};
+
+typedef lunchbox::SmallBuffer< uint32_t, 16, CountingAllocator > Buffer;
+
+void fill( Buffer& buffer, const uint32_t size, const uint32_t start )
+{
+    buffer.setSize( 0 );
+    for( uint32_t i = 0; i < size; ++i )
+        buffer.append( start + i );
+}
+
+bool check( const Buffer& buffer, const uint32_t size, const uint32_t start )
+{
+    if( buffer.getSize() != size )
+        return false;
+    for( uint32_t i = 0; i < size; ++i )
+        if( buffer[ i ] != start + i )
+            return false;
+    return true;
+}
+
+int main( int, char** )
+{
+    {
+        Buffer buffer;
+        TEST( buffer.isInline( ));
+        TEST( buffer.getMaxSize() == 16 );
+
+        fill( buffer, 16, 0 );
+        TEST( buffer.isInline( ));
+        TEST( nAllocs_ == 0 );
+        TEST( check( buffer, 16, 0 ));
+
+        // spill to the heap
+        buffer.append( 16 );
+        TEST( !buffer.isInline( ));
+        TEST( nAllocs_ == 1 );
+        TEST( check( buffer, 17, 0 ));
+
+        // pack back into the inline storage
+        buffer.setSize( 10 );
+        buffer.pack();
+        TEST( buffer.isInline( ));
+        TEST( nFrees_ == 1 );
+        TEST( buffer.getMaxSize() == 16 );
+        TEST( check( buffer, 10, 0 ));
+
+        // swap all combinations of inline and heap data
+        Buffer other;
+        fill( other, 5, 100 );
+        buffer.swap( other );
+        TEST( check( buffer, 5, 100 ));
+        TEST( check( other, 10, 0 ));
+
+        fill( other, 100, 200 );
+        TEST( !other.isInline( ));
+        buffer.swap( other );
+        TEST( !buffer.isInline( ));
+        TEST( other.isInline( ));
+        TEST( check( buffer, 100, 200 ));
+        TEST( check( other, 5, 100 ));
+
+        fill( other, 50, 300 );
+        const uint32_t* data = buffer.getData();
+        buffer.swap( other );
+        TEST( other.getData() == data );
+        TEST( check( buffer, 50, 300 ));
+        TEST( check( other, 100, 200 ));
+
+        // replace and assign
+        Buffer copy;
+        copy = buffer;
+        TEST( check( copy, 50, 300 ));
+        copy.replace( other );
+        TEST( check( copy, 100, 200 ));
+        fill( other, 3, 400 );
+        copy.replace( other );
+        TEST( check( copy, 3, 400 ));
+        copy.pack();
+        TEST( copy.isInline( ));
+
+        // move
+        Buffer moved( copy );
+        TEST( copy.isEmpty( ));
+        TEST( copy.isInline( ));
+        TEST( check( moved, 3, 400 ));
+
+        buffer.clear();
+        TEST( buffer.isInline( ));
+        TEST( buffer.isEmpty( ));
+    }
+    TESTINFO( nAllocs_ == nFrees_, nAllocs_ << " != " << nFrees_ );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/snapshot.h>
+#include <lunchbox/init.h>
+#include <lunchbox/referenced.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+#define NUPDATES 10000
+
+lunchbox::a_int32_t nObjects_( 0 );
+
+/** A version holding a counter twice, to detect torn reads. */
+class Config : public lunchbox::Referenced
+{
+public:
+    Config() : a( 0 ), b( 0 ) { ++nObjects_; }
+    Config( const Config& from )
+        : lunchbox::Referenced(), a( from.a ), b( from.b ) { ++nObjects_; }
+
+    uint32_t a;
+    uint32_t b;
+
+private:
+    virtual ~Config() { --nObjects_; }
+};
+
+typedef lunchbox::RefPtr< Config > ConfigPtr;
+typedef lunchbox::RefPtr< const Config > ConstConfigPtr;
+typedef lunchbox::Snapshot< Config > ConfigSnapshot;
+
+ConfigSnapshot snapshot_;
+lunchbox::a_int32_t running_( NTHREADS );
+
+struct Increment
+{
+    void operator()( Config& config ) const { ++config.a; ++config.b; }
+};
+
+class Writer : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        for( size_t i = 0; i < NUPDATES; ++i )
+            snapshot_.update( Increment( ));
+        --running_;
+    }
+};
+
+class Reader : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        uint32_t last = 0;
+        while( running_ > 0 )
+        {
+            const ConfigSnapshot::Reader reader( snapshot_ );
+            TEST( reader.isValid( ));
+            TESTINFO( reader->a == reader->b, reader->a << " " << reader->b );
+            TESTINFO( reader->a >= last, reader->a << " < " << last );
+            last = reader->a;
+
+            const ConstConfigPtr config = snapshot_.get();
+            TEST( config->a == config->b );
+        }
+    }
+};
+
+int main( int argc, char **argv )
+{
+    TEST( lunchbox::init( argc, argv ));
+    {
+        ConfigSnapshot snapshot;
+        TEST( !snapshot.get( ));
+        TEST( !ConfigSnapshot::Reader( snapshot ).isValid( ));
+
+        ConfigPtr first = new Config;
+        snapshot.set( first );
+        TEST( snapshot.get() == first.get( ));
+        TEST( nObjects_ == 1 );
+
+        ConstConfigPtr old = snapshot.get();
+        snapshot.update( Increment( ));
+        TEST( nObjects_ == 2 );
+        TEST( old->a == 0 );
+        TEST( snapshot.get()->a == 1 );
+        TEST( ConfigSnapshot::Reader( snapshot )->b == 1 );
+
+        // old versions are released once no reader uses them
+        old = 0;
+        first = 0;
+        TEST( snapshot.flush( ));
+        TESTINFO( nObjects_ == 1, nObjects_ );
+        {
+            const ConfigSnapshot::Reader reader( snapshot );
+            snapshot.update( Increment( ));
+            TEST( !snapshot.flush( ));
+            TEST( reader->a == 1 );
+        }
+        TEST( snapshot.flush( ));
+        TESTINFO( nObjects_ == 1, nObjects_ );
+
+        snapshot.set( ConfigPtr( ));
+        TEST( !snapshot.get( ));
+    }
+    TESTINFO( nObjects_ == 0, nObjects_ );
+
+    snapshot_.set( new Config );
+    Reader readers[ NTHREADS ];
+    Writer writers[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        TEST( readers[ i ].start( ));
+        TEST( writers[ i ].start( ));
+    }
+    for( size_t i = 0; i < NTHREADS; ++i )
+    {
+        TEST( writers[ i ].join( ));
+        TEST( readers[ i ].join( ));
+    }
+
+    TEST( snapshot_.get()->a == NTHREADS * NUPDATES );
+    TEST( lunchbox::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/spinLock.h>
+#include <lunchbox/spinWait.h>
+#include <lunchbox/thread.h>
+
+#define NTHREADS 4
+#define NLOOPS 100000
+
+lunchbox::SpinLock _lock;
+size_t _counter = 0;
+
+class Thread : public lunchbox::Thread
+{
+public:
+    virtual void run()
+    {
+        for( size_t i = 0; i < NLOOPS; ++i )
+        {
+            _lock.set();
+            ++_counter;
+            _lock.unset();
+        }
+    }
+};
+
+int main( int, char** )
+{
+    lunchbox::SpinWait spin( 2, 4 );
+    TEST( !spin.willYield( ));
+    TEST( !spin.shouldPark( ));
+    spin.spinOnce();
+    spin.spinOnce();
+    TEST( spin.willYield( ));
+    TEST( !spin.shouldPark( ));
+    spin.spinOnce();
+    spin.spinOnce();
+    TEST( spin.shouldPark( ));
+    spin.spinOnce(); // keeps yielding after reaching the park threshold
+    TEST( spin.getCount() == 4 );
+    spin.reset();
+    TEST( spin.getCount() == 0 );
+
+    const uint32_t yieldThreshold =
+        lunchbox::SpinWait::getDefaultYieldThreshold();
+    const uint32_t parkThreshold =
+        lunchbox::SpinWait::getDefaultParkThreshold();
+    TEST( yieldThreshold <= parkThreshold );
+    lunchbox::SpinWait::setDefaults( 0, 1 );
+    lunchbox::SpinWait tuned;
+    TEST( tuned.willYield( ));
+    tuned.spinOnce();
+    TEST( tuned.shouldPark( ));
+    lunchbox::SpinWait::setDefaults( yieldThreshold, parkThreshold );
+
+    // contended spin lock backs off
+    Thread threads[ NTHREADS ];
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].start( ));
+    for( size_t i = 0; i < NTHREADS; ++i )
+        TEST( threads[ i ].join( ));
+    TEST( _counter == NTHREADS * NLOOPS );
+    return EXIT_SUCCESS;
+}
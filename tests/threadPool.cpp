@@ -0,0 +1,123 @@
+
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <test.h>
+#include <lunchbox/async.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/latch.h>
+#include <lunchbox/threadPool.h>
+
+#include <boost/bind.hpp>
+#include <stdexcept>
+
+namespace
+{
+lunchbox::a_int32_t _nRuns;
+
+int answer()
+{
+    ++_nRuns;
+    return 42;
+}
+
+void count()
+{
+    ++_nRuns;
+}
+
+int fail()
+{
+    throw std::runtime_error( "task failed" );
+}
+
+int addOne( lunchbox::Future< int > future )
+{
+    return future.wait() + 1;
+}
+
+void block( lunchbox::Latch* started, lunchbox::Latch* gate )
+{
+    started->countDown();
+    gate->wait();
+}
+}
+
+int main( int, char** )
+{
+    lunchbox::ThreadPool pool( 2 );
+    TEST( pool.getSize() == 2 );
+
+    lunchbox::Future< int > result = lunchbox::async( pool, answer );
+    TEST( result.wait() == 42 );
+    lunchbox::async( pool, count ).wait();
+    TEST( _nRuns == 2 );
+
+    lunchbox::Future< int > failed = lunchbox::async( pool, fail );
+    bool thrown = false;
+    try
+    {
+        failed.wait();
+    }
+    catch( const std::runtime_error& )
+    {
+        thrown = true;
+    }
+    TEST( thrown );
+
+    lunchbox::Future< int > next = lunchbox::async( answer ).then( pool,
+                                                                   addOne );
+    TEST( next.wait() == 43 );
+
+    // a single busy worker with a queue of one task
+    lunchbox::ThreadPool busy( 1, 1 );
+    lunchbox::Latch started( 1 );
+    lunchbox::Latch gate( 1 );
+    lunchbox::Future< void > blocker =
+        lunchbox::async( busy, boost::bind( block, &started, &gate ));
+    started.wait();
+    TEST( !blocker.cancel( ));
+
+    lunchbox::Future< int > queued = lunchbox::async( busy, answer );
+    TEST( busy.getQueueDepth() == 1 );
+    TEST( !busy.tryPost( count ));
+    TEST( queued.cancel( ));
+    TEST( !queued.cancel( ));
+    TEST( queued.isReady( ));
+
+    thrown = false;
+    try
+    {
+        queued.wait();
+    }
+    catch( const lunchbox::FutureCancelled& )
+    {
+        thrown = true;
+    }
+    TEST( thrown );
+
+    gate.countDown();
+    blocker.wait();
+    TEST( busy.tryPost( count ));
+    lunchbox::async( busy, count ).wait();
+    TESTINFO( _nRuns == 5, _nRuns ); // the cancelled task did not run
+
+    // the default pool is recreated after a shutdown
+    lunchbox::ThreadPool::shutdownDefault();
+    TEST( lunchbox::async( answer ).wait() == 42 );
+    lunchbox::ThreadPool::shutdownDefault();
+    return EXIT_SUCCESS;
+}